@@ -0,0 +1,125 @@
+#include "../sgl.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Heap traffic of building a graph: every vertex is connected to the next
+// `degree` vertices of a ring, with and without reserve() and with different
+// memory resources. Global operator new is replaced to count allocations,
+// every configuration runs in its own process so its RSS is not polluted by
+// the previous ones.
+//
+// usage: sgl_bench_allocations [vertices] [edges per vertex]
+
+static std::atomic<size_t> allocations{0};
+static std::atomic<size_t> allocated_bytes{0};
+
+static void *counted_allocation(size_t size, size_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void *pointer = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (pointer == nullptr)
+        throw std::bad_alloc{};
+    return pointer;
+}
+
+void *operator new(size_t size) { return counted_allocation(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void *operator new[](size_t size) { return counted_allocation(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void *operator new(size_t size, std::align_val_t alignment) { return counted_allocation(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return counted_allocation(size, static_cast<size_t>(alignment)); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+// VmRSS or VmHWM of this process in kB
+long status_kb(const std::string &field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind(field + ":", 0) == 0)
+            return std::atol(line.c_str() + field.size() + 1);
+    }
+    return -1;
+}
+
+void run(const char *name, std::pmr::memory_resource *resource, bool reserve, int vertices_count, int degree)
+{
+    long rss_before = status_kb("VmRSS");
+    size_t allocations_before = allocations.load();
+    size_t bytes_before = allocated_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+
+    sgl::Graph<int> graph{resource};
+    if (reserve)
+        graph.reserve(vertices_count, static_cast<size_t>(vertices_count) * degree);
+
+    for (int i = 0; i < vertices_count; ++i)
+        graph.add_vertex(int{i});
+    for (int i = 0; i < vertices_count; ++i)
+        for (int d = 1; d <= degree; ++d)
+            graph.add_edge(sgl::vertex_handle(i), sgl::vertex_handle((i + d) % vertices_count), float(d));
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::printf("  %-28s %10zu allocations %10.1f MB requested %8ld kB RSS %8ld kB peak RSS %8.1f ms\n",
+                name, allocations.load() - allocations_before,
+                (allocated_bytes.load() - bytes_before) / 1e6,
+                status_kb("VmRSS") - rss_before, status_kb("VmHWM"),
+                std::chrono::duration<double>(end - start).count() * 1e3);
+}
+
+template <typename FUNCTION>
+void in_child(FUNCTION &&function)
+{
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        function();
+        std::fflush(stdout);
+        _exit(EXIT_SUCCESS);
+    }
+    waitpid(pid, nullptr, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    int vertices_count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int degree = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    std::printf("%d vertices, %lld edges\n", vertices_count, static_cast<long long>(vertices_count) * degree);
+
+    in_child([&]
+             { run("default resource", std::pmr::get_default_resource(), false, vertices_count, degree); });
+    in_child([&]
+             { run("default resource, reserve", std::pmr::get_default_resource(), true, vertices_count, degree); });
+    in_child([&]
+             {
+        std::pmr::unsynchronized_pool_resource pool;
+        run("pool resource", &pool, false, vertices_count, degree); });
+    in_child([&]
+             {
+        std::pmr::monotonic_buffer_resource arena;
+        run("monotonic arena", &arena, false, vertices_count, degree); });
+    in_child([&]
+             {
+        std::pmr::monotonic_buffer_resource arena;
+        run("monotonic arena, reserve", &arena, true, vertices_count, degree); });
+
+    return EXIT_SUCCESS;
+}
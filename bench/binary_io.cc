@@ -0,0 +1,167 @@
+#include "../sgl.hxx"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Restoring a saved graph: rebuilding it vertex by vertex and edge by edge from
+// an edge list, opening the binary file with MappedGraph, which maps and checks
+// it, thawing the mapped file back into a Graph and opening it as a CSRGraph
+// that uses the rows of the file in place. A tenth of the vertices is removed
+// before saving, so the handles of the file differ from the saved ones. Every
+// vertex, neighbor and weight of the mapped, the thawed and the in place graph
+// is compared against the original, as are the vertices BFS, DFS and
+// ParallelBFS reach and the distances PathFinder finds, once with int data
+// stored raw and once with std::string data stored through sgl::io::serializer.
+//
+// usage: sgl_bench_binary_io [vertices] [edges per vertex]
+
+template <typename FUNCTION>
+double measure(FUNCTION &&function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() * 1e3;
+}
+
+template <typename DATA_TYPE, typename MAKE>
+bool round_trip(const char *name, int vertices_count, int degree, MAKE &&make)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<sgl::vertex_handle> dis(0, vertices_count - 1);
+    std::vector<sgl::Edge> edges;
+    for (long long i = 0; i < static_cast<long long>(vertices_count) * degree / 2; ++i)
+    {
+        sgl::vertex_handle vertex1 = dis(gen), vertex2 = dis(gen);
+        if (vertex1 != vertex2)
+            edges.push_back({vertex1, vertex2, float(i % 10)});
+    }
+
+    sgl::Graph<DATA_TYPE> graph;
+    std::vector<sgl::uuid> ids;
+    double rebuild_ms = measure([&]
+                                {
+        for (int i = 0; i < vertices_count; ++i)
+            ids.push_back(graph.add_vertex(make(i)));
+        for (auto &edge : edges)
+        {
+            try
+            {
+                graph.add_edge(edge.vertex1, edge.vertex2, edge.weight);
+            }
+            catch (const std::invalid_argument &e)
+            {
+                continue;
+            }
+        } });
+
+    std::vector<sgl::uuid> removed;
+    for (size_t i = 3; i < ids.size(); i += 10)
+        removed.push_back(ids[i]);
+    graph.remove_vertices(removed);
+
+    std::string path = (std::filesystem::temp_directory_path() / ("sgl_bench_binary_io_" + std::to_string(getpid()) + ".sgl")).string();
+    double save_ms = measure([&]
+                             { sgl::io::save(graph, path); });
+
+    std::optional<sgl::io::MappedGraph<DATA_TYPE>> view;
+    double open_ms = measure([&]
+                             { view.emplace(path); });
+    double query_ms = measure([&]
+                              { view->size(view->handle(graph.begin()->get_id())); });
+    std::optional<sgl::Graph<DATA_TYPE>> thawed;
+    double thaw_ms = measure([&]
+                             { thawed.emplace(view->thaw()); });
+    std::optional<sgl::Graph<DATA_TYPE, sgl::CSRGraph>> in_place;
+    double csr_ms = measure([&]
+                            { in_place.emplace(view->csr()); });
+
+    bool ok = view->size() == graph.size() && thawed->size() == graph.size() && in_place->size() == graph.size();
+    for (auto &vertex : graph)
+    {
+        if (!ok)
+            break;
+        sgl::vertex_handle handle = view->handle(vertex.get_id());
+        auto &copy = thawed->vertex(vertex.get_id());
+        auto &mapped = in_place->vertex(vertex.get_id());
+        ok = view->data(handle) == vertex.data() && copy.data() == vertex.data() && mapped.data() == vertex.data() &&
+             view->size(handle) == vertex.size() && copy.size() == vertex.size() && mapped.size() == vertex.size();
+        for (auto it = vertex.begin(); ok && it != vertex.end(); ++it)
+            ok = view->weight(handle, view->handle(it->get_id())) == it.weight() &&
+                 thawed->get_weight(vertex.get_id(), it->get_id()) == it.weight() &&
+                 in_place->get_weight(vertex.get_id(), it->get_id()) == it.weight();
+    }
+
+    // the ids every algorithm reaches from the same vertex, sorted
+    const sgl::uuid start = graph.begin()->get_id();
+    auto reached = [&start](auto &g, auto algorithm)
+    {
+        std::vector<sgl::uuid> ids;
+        std::mutex mutex;
+        g.traverse(algorithm, start, [&ids, &mutex](auto &vertex)
+                   {
+            std::lock_guard lock{mutex};
+            ids.push_back(vertex.get_id()); });
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    using original_type = sgl::Graph<DATA_TYPE>;
+    using in_place_type = sgl::Graph<DATA_TYPE, sgl::CSRGraph>;
+    std::vector<sgl::uuid> bfs_ids;
+    double bfs_ms = measure([&]
+                            { bfs_ids = reached(*in_place, typename in_place_type::template algorithm<sgl::BFS>{}); });
+    ok = ok && bfs_ids == reached(graph, typename original_type::template algorithm<sgl::BFS>{}) &&
+         reached(*in_place, typename in_place_type::template algorithm<sgl::DFS>{}) == bfs_ids &&
+         reached(*in_place, typename in_place_type::template algorithm<sgl::ParallelBFS>{4}) == bfs_ids;
+
+    sgl::PathFinder original_finder{graph};
+    sgl::PathFinder in_place_finder{*in_place};
+    auto &original_paths = original_finder.from(start);
+    const sgl::ShortestPaths *in_place_paths = nullptr;
+    double paths_ms = measure([&]
+                              { in_place_paths = &in_place_finder.from(start); });
+    for (auto &vertex : graph)
+    {
+        if (!ok)
+            break;
+        ok = original_paths.distance(vertex.get_handle()) == in_place_paths->distance(in_place->vertex(vertex.get_id()).get_handle());
+    }
+
+    std::cout << name << ", " << graph.size() << " vertices, " << edges.size() << " edges, "
+              << std::filesystem::file_size(path) / 1e6 << " MB file" << std::endl
+              << "  rebuild from edge list: " << rebuild_ms << " ms" << std::endl
+              << "  save:                   " << save_ms << " ms" << std::endl
+              << "  open mapped:            " << open_ms << " ms" << std::endl
+              << "  first query:            " << query_ms << " ms" << std::endl
+              << "  thaw:                   " << thaw_ms << " ms" << std::endl
+              << "  open as CSRGraph:       " << csr_ms << " ms" << std::endl
+              << "  BFS in place:           " << bfs_ms << " ms" << std::endl
+              << "  Dijkstra in place:      " << paths_ms << " ms" << std::endl;
+
+    in_place.reset();
+    view.reset();
+    std::filesystem::remove(path);
+    if (!ok)
+        std::cerr << name << ": the loaded graph differs from the saved one" << std::endl;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    int vertices_count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int degree = argc > 2 ? std::atoi(argv[2]) : 16;
+
+    bool ok = round_trip<int>("int data", vertices_count, degree, [](int i)
+                              { return i; });
+    ok = round_trip<std::string>("std::string data", vertices_count, degree, [](int i)
+                                 { return "vertex " + std::to_string(i); }) &&
+         ok;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,138 @@
+#include "../sgl.hxx"
+
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+// Loading a streamed edge list edge by edge with add_edge, skipping the ones
+// it rejects, and as one batch with add_edges: a random graph, the same graph
+// listed in both directions as many edge list files are, and a star whose hub
+// makes the per-edge duplicate check quadratic. Then a tenth of the vertices,
+// including leaves of the star, is removed one by one and as a batch. Both
+// ways must build the same graph.
+//
+// usage: sgl_bench_bulk_load [vertices] [edges per vertex] [hub degree]
+
+template <typename FUNCTION>
+double measure(FUNCTION &&function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+size_t edges_count(const sgl::Graph<int> &graph)
+{
+    size_t count = 0;
+    for (auto &vertex : graph)
+        count += vertex.size();
+    return count / 2;
+}
+
+sgl::Graph<int> empty_graph(int vertices_count, size_t edges)
+{
+    sgl::Graph<int> graph;
+    graph.reserve(vertices_count, edges);
+    std::vector<int> data(vertices_count);
+    std::iota(data.begin(), data.end(), 0);
+    graph.add_vertices(data);
+    return graph;
+}
+
+bool compare(const char *name, const std::vector<sgl::Edge> &edges, int vertices_count)
+{
+    sgl::Graph<int> single = empty_graph(vertices_count, edges.size());
+    double single_s = measure([&]
+                              {
+        for (auto &edge : edges)
+        {
+            try
+            {
+                single.add_edge(edge.vertex1, edge.vertex2, edge.weight);
+            }
+            catch (const std::invalid_argument &e)
+            {
+                continue;
+            }
+        } });
+
+    sgl::Graph<int> batch = empty_graph(vertices_count, edges.size());
+    double batch_s = measure([&]
+                             { batch.add_edges(edges, sgl::DuplicatePolicy::KEEP_FIRST); });
+
+    std::cout << name << ", " << edges.size() << " edges" << std::endl
+              << "  add_edge:  " << edges.size() / single_s / 1e6 << " M edges/s" << std::endl
+              << "  add_edges: " << edges.size() / batch_s / 1e6 << " M edges/s" << std::endl;
+
+    if (edges_count(single) != edges_count(batch))
+    {
+        std::cerr << name << ": add_edge built " << edges_count(single) << " edges, add_edges " << edges_count(batch) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int vertices_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int degree = argc > 2 ? std::atoi(argv[2]) : 16;
+    int hub_degree = argc > 3 ? std::atoi(argv[3]) : 20000;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<sgl::vertex_handle> dis(0, vertices_count - 1);
+
+    std::vector<sgl::Edge> random;
+    for (long long i = 0; i < static_cast<long long>(vertices_count) * degree / 2; ++i)
+    {
+        sgl::vertex_handle vertex1 = dis(gen), vertex2 = dis(gen);
+        if (vertex1 != vertex2)
+            random.push_back({vertex1, vertex2, float(i % 10)});
+    }
+
+    std::vector<sgl::Edge> both_directions;
+    for (auto &edge : random)
+    {
+        both_directions.push_back(edge);
+        both_directions.push_back({edge.vertex2, edge.vertex1, edge.weight});
+    }
+
+    std::vector<sgl::Edge> star;
+    for (int i = 1; i <= std::min(hub_degree, vertices_count - 1); ++i)
+        star.push_back({0, sgl::vertex_handle(i), float(i)});
+
+    bool ok = compare("random", random, vertices_count);
+    ok = compare("both directions", both_directions, vertices_count) && ok;
+    ok = compare("star", star, vertices_count) && ok;
+
+    std::vector<sgl::vertex_handle> removed;
+    for (int i = 1; i < vertices_count; i += 10)
+        removed.push_back(sgl::vertex_handle(i));
+
+    sgl::Graph<int> single = empty_graph(vertices_count, random.size() + star.size());
+    single.add_edges(random, sgl::DuplicatePolicy::KEEP_FIRST);
+    single.add_edges(star, sgl::DuplicatePolicy::KEEP_FIRST);
+    sgl::Graph<int> batch = empty_graph(vertices_count, random.size() + star.size());
+    batch.add_edges(random, sgl::DuplicatePolicy::KEEP_FIRST);
+    batch.add_edges(star, sgl::DuplicatePolicy::KEEP_FIRST);
+
+    double single_s = measure([&]
+                              {
+        for (auto vertex : removed)
+            single.remove_vertex(single.vertex(vertex).get_id()); });
+    double batch_s = measure([&]
+                             { batch.remove_vertices(removed); });
+
+    std::cout << "removing " << removed.size() << " vertices" << std::endl
+              << "  remove_vertex:   " << single_s * 1e3 << " ms" << std::endl
+              << "  remove_vertices: " << batch_s * 1e3 << " ms" << std::endl;
+
+    if (edges_count(single) != edges_count(batch) || single.size() != batch.size())
+    {
+        std::cerr << "remove_vertices left " << edges_count(batch) << " edges instead of " << edges_count(single) << std::endl;
+        ok = false;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,158 @@
+#include "../sgl.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Neighbor-scan throughput: builds a random graph with the public API, copies
+// it into every data structure, then measures a full
+// `for (auto &vertex : graph) for (auto &neighbor : vertex)` sweep and a BFS
+// over the same graph, ParallelBFS with 1, 2, 4, ... up to the given number
+// of threads, plus the dense kernels of the data structures that have
+// them. The copies are made with thaw and freeze, which must not share
+// storage with the source graph.
+//
+// usage: sgl_bench_neighbor_scan [vertices] [edges per vertex] [repetitions] [threads]
+
+sgl::Graph<int> build(int vertices_count, int degree)
+{
+    sgl::Graph<int> graph;
+
+    std::vector<sgl::uuid> vertices;
+    for (int i = 0; i < vertices_count; ++i)
+        vertices.push_back(graph.add_vertex(int{i}));
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, vertices_count - 1);
+
+    long long edges_count = static_cast<long long>(vertices_count) * degree / 2;
+    for (long long created_edges = 0; created_edges < edges_count;)
+    {
+        try
+        {
+            graph.add_edge(vertices[dis(gen)], vertices[dis(gen)]);
+            ++created_edges;
+        }
+        catch (const std::exception &e)
+        {
+            continue;
+        }
+    }
+
+    return graph;
+}
+
+template <template <typename> typename DATA_STRUCTURE>
+bool run(const char *name, const sgl::Graph<int> &source, int degree, int repetitions, unsigned threads)
+{
+    sgl::Graph<int, DATA_STRUCTURE> graph = source.template thaw<DATA_STRUCTURE>();
+
+    int vertices_count = static_cast<int>(graph.size());
+    long long edges_count = static_cast<long long>(vertices_count) * degree / 2;
+
+    long long scanned = 0;
+    long long checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r)
+    {
+        for (auto &vertex : graph)
+        {
+            for (auto &neighbor : vertex)
+            {
+                checksum += neighbor.data();
+                ++scanned;
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double scan_seconds = std::chrono::duration<double>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r)
+    {
+        graph.template traverse<sgl::BFS>([&checksum](auto &vertex)
+                                          { checksum += vertex.data(); });
+    }
+    end = std::chrono::steady_clock::now();
+
+    double bfs_seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << name << ": " << vertices_count << " vertices, " << edges_count << " edges" << std::endl
+              << "  neighbor scan: " << scanned / scan_seconds / 1e6 << " M neighbors/s ("
+              << scan_seconds * 1e3 / repetitions << " ms per sweep)" << std::endl
+              << "  BFS:           " << bfs_seconds * 1e3 / repetitions << " ms per traversal" << std::endl;
+
+    for (unsigned count = 1;; count = std::min(2 * count, threads))
+    {
+        std::atomic<long long> parallel_checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; ++r)
+        {
+            graph.traverse(typename sgl::Graph<int, DATA_STRUCTURE>::template algorithm<sgl::ParallelBFS>{count}, graph.begin()->get_id(), [&parallel_checksum](auto &vertex)
+                           { parallel_checksum.fetch_add(vertex.data(), std::memory_order_relaxed); });
+        }
+        end = std::chrono::steady_clock::now();
+
+        double parallel_bfs_seconds = std::chrono::duration<double>(end - start).count();
+        checksum += parallel_checksum;
+
+        std::cout << "  ParallelBFS:   " << parallel_bfs_seconds * 1e3 / repetitions << " ms per traversal ("
+                  << count << " threads)" << std::endl;
+        if (count >= threads)
+            break;
+    }
+
+    std::cout << "  checksum:      " << checksum << std::endl;
+
+    if constexpr (requires { graph.triangles(); })
+    {
+        start = std::chrono::steady_clock::now();
+        size_t triangles = 0;
+        for (int r = 0; r < repetitions; ++r)
+        {
+            triangles = graph.triangles();
+        }
+        end = std::chrono::steady_clock::now();
+
+        double triangles_seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "  triangles:     " << triangles_seconds * 1e3 / repetitions << " ms per count (" << triangles << ")" << std::endl;
+    }
+
+    // a copy to the same data structure has vertices of its own, and
+    // modifying it leaves the graph alone
+    auto copy = graph.template thaw<DATA_STRUCTURE>();
+    bool shared = &*copy.begin() == &*graph.begin();
+    if constexpr (!std::is_same_v<DATA_STRUCTURE<int>, sgl::CSRGraph<int>>)
+    {
+        copy.add_vertex(int{-1});
+        copy.remove_vertex(graph.begin()->get_id());
+    }
+    if (shared || graph.size() != source.size())
+    {
+        std::cerr << name << ": modifying a copy changed the graph it was copied from" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int vertices_count = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int degree = argc > 2 ? std::atoi(argv[2]) : 8;
+    int repetitions = argc > 3 ? std::atoi(argv[3]) : 3;
+    unsigned threads = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4])) : std::thread::hardware_concurrency();
+    threads = std::max(threads, 1u);
+
+    sgl::Graph<int> source = build(vertices_count, degree);
+
+    bool ok = run<sgl::AdjacencyList>("AdjacencyList", source, degree, repetitions, threads);
+    ok = run<sgl::AdjacencyMatrix>("AdjacencyMatrix", source, degree, repetitions, threads) && ok;
+    ok = run<sgl::CSRGraph>("CSRGraph", source, degree, repetitions, threads) && ok;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+#include "../sgl.hxx"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Shortest path queries on a road-like grid: every vertex is connected to its
+// right and lower neighbor with a random weight between 1 and 10. Every query
+// kind is checked against a full Dijkstra run from the same source.
+//
+// usage: sgl_bench_shortest_path [width] [height] [queries]
+
+template <typename FUNCTION>
+double measure(int repetitions, FUNCTION &&function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r)
+    {
+        function(r);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() * 1e3 / repetitions;
+}
+
+int main(int argc, char *argv[])
+{
+    int width = argc > 1 ? std::atoi(argv[1]) : 300;
+    int height = argc > 2 ? std::atoi(argv[2]) : 300;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 20;
+
+    sgl::Graph<int> graph;
+    std::vector<sgl::uuid> vertices;
+    for (int i = 0; i < width * height; ++i)
+        vertices.push_back(graph.add_vertex(int{i}));
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> weight(1, 10);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (x + 1 < width)
+                graph.add_edge(vertices[y * width + x], vertices[y * width + x + 1], weight(gen));
+            if (y + 1 < height)
+                graph.add_edge(vertices[y * width + x], vertices[(y + 1) * width + x], weight(gen));
+        }
+    }
+
+    std::uniform_int_distribution<int> pick(0, width * height - 1);
+    std::vector<std::pair<sgl::uuid, sgl::uuid>> pairs;
+    for (int q = 0; q < queries; ++q)
+        pairs.emplace_back(vertices[pick(gen)], vertices[pick(gen)]);
+
+    sgl::PathFinder finder{graph};
+    std::vector<float> expected;
+    for (auto &[source, target] : pairs)
+        expected.push_back(finder.from(source).distance(graph.handle(target)));
+
+    bool ok = true;
+    auto check = [&](const char *name, int q, float distance)
+    {
+        if (distance != expected[q])
+        {
+            std::cerr << name << ": query " << q << " returned " << distance << " instead of " << expected[q] << std::endl;
+            ok = false;
+        }
+    };
+
+    double full = measure(queries, [&](int q)
+                          { finder.from(pairs[q].first); });
+
+    double early_exit = measure(queries, [&](int q)
+                                { check("early exit", q, finder.from(pairs[q].first, pairs[q].second).distance(graph.handle(pairs[q].second))); });
+
+    double astar = measure(queries, [&](int q)
+                           {
+        int target = graph.vertex(pairs[q].second).data();
+        auto manhattan = [target, width](auto &vertex)
+        {
+            return static_cast<float>(std::abs(vertex.data() % width - target % width) + std::abs(vertex.data() / width - target / width));
+        };
+        check("A*", q, finder.astar(pairs[q].first, pairs[q].second, manhattan).distance(graph.handle(pairs[q].second))); });
+
+    double bidirectional = measure(queries, [&](int q)
+                                   {
+        sgl::Path path = finder.bidirectional(pairs[q].first, pairs[q].second);
+        float length = 0;
+        for (size_t i = 1; i < path.vertices.size(); ++i)
+            length += graph.get_weight(path.vertices[i - 1], path.vertices[i]);
+        check("bidirectional", q, path.distance);
+        check("bidirectional path", q, length); });
+
+    double delta_stepping = measure(queries, [&](int q)
+                                    { check("delta-stepping", q, finder.delta_stepping(pairs[q].first).distance(graph.handle(pairs[q].second))); });
+
+    std::vector<sgl::uuid> sources, targets;
+    for (auto &[source, target] : pairs)
+    {
+        sources.push_back(source);
+        targets.push_back(target);
+    }
+    std::vector<float> table;
+    double table_ms = measure(1, [&](int)
+                              { table = finder.distance_table(sources, targets); });
+    for (int q = 0; q < queries; ++q)
+        check("distance table", q, table[q * queries + q]);
+
+    std::cout << "grid " << width << "x" << height << ", " << queries << " queries" << std::endl
+              << "  full Dijkstra:  " << full << " ms per query" << std::endl
+              << "  early exit:     " << early_exit << " ms per query" << std::endl
+              << "  A*:             " << astar << " ms per query" << std::endl
+              << "  bidirectional:  " << bidirectional << " ms per query" << std::endl
+              << "  delta-stepping: " << delta_stepping << " ms per query (" << std::thread::hardware_concurrency() << " threads)" << std::endl
+              << "  distance table: " << table_ms << " ms for " << queries << "x" << queries << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,379 @@
+#include "../sgl.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Regression suite: synthetic graphs from three generators, each loaded into
+// AdjacencyList, AdjacencyMatrix and a CSRGraph frozen from the list, timing
+// construction, vertex and neighbor iteration, traversals, shortest paths and
+// removal. The results are written to stdout as one JSON document so runs of
+// different versions can be compared, progress goes to stderr. Every backend
+// must agree on the edge count, the weight sum, the vertices reached by the
+// traversals and the shortest path distances of a generator.
+//
+// Generators, with n = 2^scale vertices:
+//  - erdos_renyi: n * degree / 2 edges between uniformly random vertices
+//  - rmat: as many edges drawn with the R-MAT recursion (a = 0.57, b = c =
+//    0.19), which gives the skewed, power-law degrees of social graphs
+//  - grid: a road-like lattice, every vertex connected to its right and lower
+//    neighbor
+// Duplicate edges and self loops are dropped, weights are between 1 and 10.
+// AdjacencyMatrix is skipped above scale 13, its storage is quadratic in the
+// number of vertices.
+//
+// Built as sgl_bench_instrumented with SGL_INSTRUMENT, the Stats of every
+// graph are added to the output.
+//
+// usage: sgl_bench [scale] [edges per vertex] [queries]
+
+struct Workload
+{
+    std::string generator;
+    int vertices;
+    std::vector<sgl::Edge> edges;
+};
+
+struct Result
+{
+    std::string generator;
+    std::string backend;
+    std::string benchmark;
+    size_t items;
+    double ms;
+};
+
+// what every backend has to agree on
+struct Checksums
+{
+    long long data = 0;
+    size_t edges = 0;
+    double weights = 0;
+    size_t bfs = 0;
+    size_t dfs = 0;
+    size_t parallel_bfs = 0;
+    double distances = 0;
+
+    bool operator==(const Checksums &other) const = default;
+};
+
+template <typename FUNCTION>
+double measure(FUNCTION &&function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() * 1e3;
+}
+
+void deduplicate(std::vector<sgl::Edge> &edges)
+{
+    std::erase_if(edges, [](const sgl::Edge &edge)
+                  { return edge.vertex1 == edge.vertex2; });
+    for (auto &edge : edges)
+    {
+        if (edge.vertex1 > edge.vertex2)
+            std::swap(edge.vertex1, edge.vertex2);
+    }
+    std::sort(edges.begin(), edges.end(), [](const sgl::Edge &a, const sgl::Edge &b)
+              { return std::pair{a.vertex1, a.vertex2} < std::pair{b.vertex1, b.vertex2}; });
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const sgl::Edge &a, const sgl::Edge &b)
+                            { return a.vertex1 == b.vertex1 && a.vertex2 == b.vertex2; }),
+                edges.end());
+    // inserted in random order, not sorted by handle
+    std::shuffle(edges.begin(), edges.end(), std::mt19937{7});
+}
+
+Workload erdos_renyi(int scale, int degree, std::mt19937 &gen)
+{
+    Workload workload{"erdos_renyi", 1 << scale, {}};
+    std::uniform_int_distribution<sgl::vertex_handle> vertex(0, workload.vertices - 1);
+    std::uniform_int_distribution<int> weight(1, 10);
+    for (long long i = 0; i < static_cast<long long>(workload.vertices) * degree / 2; ++i)
+        workload.edges.push_back({vertex(gen), vertex(gen), float(weight(gen))});
+    deduplicate(workload.edges);
+    return workload;
+}
+
+Workload rmat(int scale, int degree, std::mt19937 &gen)
+{
+    Workload workload{"rmat", 1 << scale, {}};
+    std::uniform_real_distribution<double> quadrant(0, 1);
+    std::uniform_int_distribution<int> weight(1, 10);
+    for (long long i = 0; i < static_cast<long long>(workload.vertices) * degree / 2; ++i)
+    {
+        sgl::vertex_handle vertex1 = 0, vertex2 = 0;
+        for (int bit = 0; bit < scale; ++bit)
+        {
+            double p = quadrant(gen);
+            vertex1 = vertex1 << 1 | (p >= 0.57 + 0.19);
+            vertex2 = vertex2 << 1 | ((p >= 0.57 && p < 0.57 + 0.19) || p >= 0.57 + 0.19 + 0.19);
+        }
+        workload.edges.push_back({vertex1, vertex2, float(weight(gen))});
+    }
+    deduplicate(workload.edges);
+    return workload;
+}
+
+Workload grid(int scale, std::mt19937 &gen)
+{
+    int width = 1 << (scale / 2), height = 1 << (scale - scale / 2);
+    Workload workload{"grid", width * height, {}};
+    std::uniform_int_distribution<int> weight(1, 10);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            sgl::vertex_handle vertex = y * width + x;
+            if (x + 1 < width)
+                workload.edges.push_back({vertex, vertex + 1, float(weight(gen))});
+            if (y + 1 < height)
+                workload.edges.push_back({vertex, vertex + sgl::vertex_handle(width), float(weight(gen))});
+        }
+    }
+    deduplicate(workload.edges);
+    return workload;
+}
+
+template <template <typename> typename DATA_STRUCTURE>
+const char *backend_name();
+template <>
+const char *backend_name<sgl::AdjacencyList>() { return "AdjacencyList"; }
+template <>
+const char *backend_name<sgl::AdjacencyMatrix>() { return "AdjacencyMatrix"; }
+template <>
+const char *backend_name<sgl::CSRGraph>() { return "CSRGraph"; }
+
+class Suite
+{
+public:
+    Suite(int queries) : m_queries{queries} {}
+
+    template <template <typename> typename DATA_STRUCTURE>
+    Checksums run(const Workload &workload)
+    {
+        const char *backend = backend_name<DATA_STRUCTURE>();
+        m_backend = backend;
+        m_workload = &workload;
+
+        sgl::Graph<int, DATA_STRUCTURE> graph = build<DATA_STRUCTURE>(workload);
+        Checksums checksums = read(graph);
+
+        if constexpr (!std::is_same_v<DATA_STRUCTURE<int>, sgl::CSRGraph<int>>)
+        {
+            std::vector<sgl::uuid> removed;
+            for (auto &vertex : graph)
+            {
+                if (vertex.data() % 10 == 1)
+                    removed.push_back(vertex.get_id());
+            }
+            record("remove_vertex", removed.size(), measure([&]
+                                                            {
+                for (auto &id : removed)
+                    graph.remove_vertex(id); }));
+        }
+
+        if (sgl::Stats::enabled)
+        {
+            std::ostringstream stats;
+            stats << graph.stats();
+            m_stats.push_back("{\"generator\": \"" + workload.generator + "\", \"backend\": \"" + backend + "\", \"stats\": " + stats.str() + "}");
+        }
+        return checksums;
+    }
+
+    void print(std::ostream &os, int scale, int degree) const
+    {
+        os << "{" << std::endl
+           << "  \"instrumented\": " << (sgl::Stats::enabled ? "true" : "false") << "," << std::endl
+           << "  \"scale\": " << scale << "," << std::endl
+           << "  \"edges_per_vertex\": " << degree << "," << std::endl
+           << "  \"queries\": " << m_queries << "," << std::endl
+           << "  \"results\": [" << std::endl;
+        for (size_t i = 0; i < m_results.size(); ++i)
+        {
+            const Result &result = m_results[i];
+            os << "    {\"generator\": \"" << result.generator << "\", \"backend\": \"" << result.backend
+               << "\", \"benchmark\": \"" << result.benchmark << "\", \"items\": " << result.items
+               << ", \"ms\": " << result.ms << ", \"items_per_second\": " << (result.ms > 0 ? result.items / result.ms * 1e3 : 0)
+               << "}" << (i + 1 < m_results.size() ? "," : "") << std::endl;
+        }
+        os << "  ]," << std::endl
+           << "  \"stats\": [" << std::endl;
+        for (size_t i = 0; i < m_stats.size(); ++i)
+            os << "    " << m_stats[i] << (i + 1 < m_stats.size() ? "," : "") << std::endl;
+        os << "  ]" << std::endl
+           << "}" << std::endl;
+    }
+
+private:
+    void record(const char *benchmark, size_t items, double ms)
+    {
+        std::cerr << m_workload->generator << " " << m_backend << " " << benchmark << ": " << ms << " ms" << std::endl;
+        m_results.push_back({m_workload->generator, m_backend, benchmark, items, ms});
+    }
+
+    template <template <typename> typename DATA_STRUCTURE>
+    sgl::Graph<int, DATA_STRUCTURE> build(const Workload &workload)
+    {
+        if constexpr (std::is_same_v<DATA_STRUCTURE<int>, sgl::CSRGraph<int>>)
+        {
+            sgl::Graph<int> source;
+            std::vector<int> data(workload.vertices);
+            std::iota(data.begin(), data.end(), 0);
+            source.add_vertices(data);
+            source.add_edges(workload.edges);
+
+            sgl::Graph<int, sgl::CSRGraph> graph;
+            record("freeze", workload.edges.size(), measure([&]
+                                                            { graph = source.freeze(); }));
+            return graph;
+        }
+        else
+        {
+            sgl::Graph<int, DATA_STRUCTURE> batch;
+            record("add_edges", workload.edges.size(), measure([&]
+                                                               {
+                std::vector<int> data(workload.vertices);
+                std::iota(data.begin(), data.end(), 0);
+                batch.add_vertices(data);
+                batch.add_edges(workload.edges); }));
+
+            sgl::Graph<int, DATA_STRUCTURE> graph;
+            record("add_vertex", workload.vertices, measure([&]
+                                                            {
+                for (int i = 0; i < workload.vertices; ++i)
+                    graph.add_vertex(int{i}); }));
+            record("add_edge", workload.edges.size(), measure([&]
+                                                              {
+                for (auto &edge : workload.edges)
+                    graph.add_edge(edge.vertex1, edge.vertex2, edge.weight); }));
+            return graph;
+        }
+    }
+
+    template <typename GRAPH>
+    Checksums read(GRAPH &graph)
+    {
+        Checksums checksums;
+
+        // the sweeps are too short to time once
+        constexpr int sweeps = 10;
+
+        long long data = 0;
+        record("vertex_iteration", sweeps * graph.size(), measure([&]
+                                                                  {
+            for (int sweep = 0; sweep < sweeps; ++sweep)
+            {
+                for (auto &vertex : graph)
+                    data += vertex.data();
+            } }));
+        checksums.data = data / sweeps;
+
+        size_t scanned = 0;
+        double weights = 0;
+        record("neighbor_iteration", sweeps * 2 * m_workload->edges.size(), measure([&]
+                                                                                     {
+            for (int sweep = 0; sweep < sweeps; ++sweep)
+            {
+                for (auto &vertex : graph)
+                {
+                    for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                    {
+                        weights += it.weight();
+                        ++scanned;
+                    }
+                }
+            } }));
+        checksums.edges = scanned / sweeps / 2;
+        checksums.weights = weights / sweeps;
+
+        // the vertex with data 0 is the start of every traversal and the
+        // first source of the shortest path queries
+        sgl::uuid start;
+        for (auto &vertex : graph)
+        {
+            if (vertex.data() == 0)
+                start = vertex.get_id();
+        }
+
+        auto counter = [](size_t &count)
+        {
+            return [&count](auto &)
+            { ++count; };
+        };
+        record("bfs", graph.size(), measure([&]
+                                            { graph.template traverse<sgl::BFS>(start, counter(checksums.bfs)); }));
+        record("dfs", graph.size(), measure([&]
+                                            { graph.template traverse<sgl::DFS>(start, counter(checksums.dfs)); }));
+        std::atomic<size_t> reached{0};
+        record("parallel_bfs", graph.size(), measure([&]
+                                                     { graph.template traverse<sgl::ParallelBFS>(start, [&reached](auto &)
+                                                                                                 { reached.fetch_add(1, std::memory_order_relaxed); }); }));
+        checksums.parallel_bfs = reached.load();
+
+        std::vector<sgl::uuid> sources{start};
+        std::mt19937 gen(42);
+        for (auto &vertex : graph)
+        {
+            if (sources.size() < static_cast<size_t>(m_queries) && std::uniform_int_distribution<int>(0, m_workload->vertices / m_queries)(gen) == 0)
+                sources.push_back(vertex.get_id());
+        }
+        sgl::PathFinder finder{graph};
+        record("dijkstra", sources.size(), measure([&]
+                                                   {
+            for (auto &source : sources)
+            {
+                for (auto distance : finder.from(source).distances())
+                {
+                    if (std::isfinite(distance))
+                        checksums.distances += distance;
+                }
+            } }));
+
+        return checksums;
+    }
+
+    int m_queries;
+    std::string m_backend;
+    const Workload *m_workload = nullptr;
+    std::vector<Result> m_results;
+    std::vector<std::string> m_stats;
+};
+
+int main(int argc, char *argv[])
+{
+    int scale = argc > 1 ? std::atoi(argv[1]) : 12;
+    int degree = argc > 2 ? std::atoi(argv[2]) : 16;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    std::mt19937 gen(42);
+    std::vector<Workload> workloads;
+    workloads.push_back(erdos_renyi(scale, degree, gen));
+    workloads.push_back(rmat(scale, degree, gen));
+    workloads.push_back(grid(scale, gen));
+
+    constexpr int max_matrix_scale = 13;
+
+    Suite suite{queries};
+    bool ok = true;
+    for (auto &workload : workloads)
+    {
+        Checksums list = suite.run<sgl::AdjacencyList>(workload);
+        Checksums matrix = scale <= max_matrix_scale ? suite.run<sgl::AdjacencyMatrix>(workload) : list;
+        Checksums csr = suite.run<sgl::CSRGraph>(workload);
+        if (list.edges != workload.edges.size() || list.data != (workload.vertices - 1LL) * workload.vertices / 2 || !(list == matrix) || !(list == csr))
+        {
+            std::cerr << workload.generator << ": the backends disagree" << std::endl;
+            ok = false;
+        }
+    }
+
+    suite.print(std::cout, scale, degree);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
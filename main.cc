@@ -1,5 +1,6 @@
 #include "sgl.hxx"
 
+#include <atomic>
 #include <chrono>
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[])
@@ -71,6 +72,15 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[])
     graph1.traverse(f);
     std::cout << std::endl;
 
+    std::cout << "graph1 parallel BFS depths from f: " << std::endl;
+    std::atomic<int> visited_count = 0;
+    auto tree = graph1.traverse<sgl::ParallelBFS>(f, [&visited_count](auto &)
+                                                  { ++visited_count; });
+    for (auto &vertex : graph1)
+        std::cout << vertex << " " << tree.depth[vertex.get_handle()] << std::endl;
+    std::cout << visited_count << " vertices in " << tree.levels() << " levels" << std::endl;
+    std::cout << std::endl;
+
     std::cout << "graph2 BFS: " << std::endl;
     graph2.traverse();
     std::cout << std::endl;
@@ -120,6 +130,17 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[])
     graph2.print();
     std::cout << std::endl;
 
+    std::cout << "graph1 frozen BFS: " << std::endl;
+    auto frozen = graph1.freeze();
+    frozen(b).data() += " Y";
+    frozen.traverse<sgl::BFS>(b);
+    std::cout << std::endl;
+
+    std::cout << "graph1 thawed: " << std::endl;
+    auto thawed = frozen.thaw<sgl::AdjacencyMatrix>();
+    thawed.add_edge(b, thawed.add_vertex("J"));
+    std::cout << sgl::VertexFormat::LONG << thawed << std::endl;
+
     //////////////////////////////////////////////////////////////////////////////
     //
     //       RUNTIME TEST
@@ -153,11 +174,11 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[])
     } while (created_edges < edges_count);
 
     auto start1 = std::chrono::high_resolution_clock::now();
-    auto map = dijkstra(graph_dijkstra2, vertices[0]);
+    auto paths = dijkstra(graph_dijkstra2, vertices[0]);
     auto end1 = std::chrono::high_resolution_clock::now();
 
     std::cout << "time taken: " << std::chrono::duration_cast<std::chrono::milliseconds>(end1 - start1).count() << "ms" << std::endl;
-    std::cout << "shortest distance to the 50th vertex: " << map[vertices[50]].first << std::endl;
+    std::cout << "shortest distance to the 50th vertex: " << paths.distance(graph_dijkstra2.handle(vertices[50])) << std::endl;
 
     //
     //       END OF RUNTIME TEST
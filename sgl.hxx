@@ -1,17 +1,74 @@
 #ifndef SGL_HH
 #define SGL_HH
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 
-#include <map>
 #include <queue>
-#include <set>
 #include <stack>
+#include <unordered_map>
+#include <vector>
 
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <cstdint>
 #include <random>
-#include <sstream>
+#include <thread>
+
+// io::MappedGraph maps files where mmap is available, define SGL_HAS_MMAP as
+// 0 to read them into memory instead
+#ifndef SGL_HAS_MMAP
+#if __has_include(<sys/mman.h>)
+#define SGL_HAS_MMAP 1
+#else
+#define SGL_HAS_MMAP 0
+#endif
+#endif
+
+#if SGL_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Define SGL_INSTRUMENT as 1 to fill in Graph::stats(), lookups, traversals,
+// shortest path queries and allocations are counted and the public
+// operations are timed. Without it the counting statements compile to
+// nothing and their arguments are not evaluated.
+#ifndef SGL_INSTRUMENT
+#define SGL_INSTRUMENT 0
+#endif
+
+#if SGL_INSTRUMENT
+#define SGL_COUNT(stats, counter, n) (stats).counter.fetch_add((n), std::memory_order_relaxed)
+#define SGL_TIME(stats, phase) const ::sgl::Stats::timer sgl_phase_timer{(stats), (phase)}
+#else
+#define SGL_COUNT(stats, counter, n) ((void)0)
+#define SGL_TIME(stats, phase) ((void)0)
+#endif
 
 namespace sgl
 {
@@ -23,18 +80,21 @@ namespace sgl
     class uuid;
 
     template <typename DATA_TYPE>
+    class AdjacencyList;
+
+    template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE = AdjacencyList>
     class Vertex;
 
     class VertexPrinter;
 
-    template <typename DATA_TYPE>
+    template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
     class DataStructureBase;
 
     template <typename DATA_TYPE>
-    class AdjacencyList;
+    class AdjacencyMatrix;
 
     template <typename DATA_TYPE>
-    class AdjacencyMatrix;
+    class CSRGraph;
 
     template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
     class Graph;
@@ -45,6 +105,15 @@ namespace sgl
     template <typename DATA_STRUCTURE>
     class DFS;
 
+    template <typename DATA_STRUCTURE>
+    class ParallelBFS;
+
+    namespace io
+    {
+        template <typename DATA_TYPE>
+        class MappedGraph;
+    }
+
     //
     //       END OF FORWARD DECLARATIONS
     //
@@ -77,75 +146,264 @@ namespace sgl
         ALL
     };
 
-    class uuid
+    // what Graph::add_edges does with an edge that is already in the graph or
+    // appears more than once in the batch
+    enum DuplicatePolicy
+    {
+        REJECT,    // throw std::invalid_argument, the graph is not modified
+        KEEP_FIRST, // keep the weight of the existing edge or first occurrence
+        KEEP_LAST,  // keep the weight of the last occurrence
+        KEEP_MIN    // keep the smallest weight
+    };
+
+    using vertex_handle = std::uint32_t;
+
+    // undirected edge between two vertex handles, the element type of the
+    // batches taken by Graph::add_edges
+    struct Edge
+    {
+        vertex_handle vertex1;
+        vertex_handle vertex2;
+        float weight = 0;
+    };
+
+    // operations timed by Stats
+    enum Phase
+    {
+        CONSTRUCTION,  // add_vertex, add_vertices, add_edge, add_edges
+        REMOVAL,       // remove_vertex, remove_vertices, remove_edge, remove_if
+        TRAVERSAL,     // Graph::traverse
+        SHORTEST_PATH, // PathFinder queries
+    };
+
+    // Counters of a graph, see SGL_INSTRUMENT. They are relaxed atomics, so
+    // they can be read from another thread while the graph is in use, and
+    // they keep counting until reset.
+    class Stats
     {
     public:
-        uuid()
+        static constexpr bool enabled = SGL_INSTRUMENT;
+        static constexpr size_t phases = 4;
+
+        struct phase_stats
+        {
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> nanoseconds{0};
+        };
+
+        // allocations from the memory resource of the graph, the storage of
+        // its vertices, edges and index but not what the vertex data allocates
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> deallocations{0};
+        std::atomic<std::uint64_t> allocated_bytes{0};
+        // uuid to handle lookups in the index
+        std::atomic<std::uint64_t> lookups{0};
+        // vertices visited by BFS, DFS and ParallelBFS, edges scanned by
+        // PathFinder queries
+        std::atomic<std::uint64_t> vertices_visited{0};
+        std::atomic<std::uint64_t> edges_relaxed{0};
+        std::array<phase_stats, phases> phase;
+
+        Stats() = default;
+        Stats(const Stats &other) = delete;
+        Stats &operator=(const Stats &other) = delete;
+
+        void reset()
         {
-            static std::random_device rd;
-            static std::mt19937_64 gen(1);
-            static std::uniform_int_distribution<> dis(0, 15);
+            for (auto *counter : {&allocations, &deallocations, &allocated_bytes, &lookups, &vertices_visited, &edges_relaxed})
+            {
+                counter->store(0, std::memory_order_relaxed);
+            }
+            for (auto &stats : phase)
+            {
+                stats.calls.store(0, std::memory_order_relaxed);
+                stats.nanoseconds.store(0, std::memory_order_relaxed);
+            }
+        }
 
-            std::stringstream ss;
-            for (int i = 0; i < 10; ++i)
+        // one JSON object
+        std::ostream &print(std::ostream &os = std::cout) const
+        {
+            constexpr const char *phase_names[phases] = {"construction", "removal", "traversal", "shortest_path"};
+
+            os << "{\"enabled\": " << (enabled ? "true" : "false")
+               << ", \"allocations\": " << allocations.load(std::memory_order_relaxed)
+               << ", \"deallocations\": " << deallocations.load(std::memory_order_relaxed)
+               << ", \"allocated_bytes\": " << allocated_bytes.load(std::memory_order_relaxed)
+               << ", \"lookups\": " << lookups.load(std::memory_order_relaxed)
+               << ", \"vertices_visited\": " << vertices_visited.load(std::memory_order_relaxed)
+               << ", \"edges_relaxed\": " << edges_relaxed.load(std::memory_order_relaxed)
+               << ", \"phases\": {";
+            for (size_t i = 0; i < phases; ++i)
             {
-                int rand_val = dis(gen);
-                char hex_digit = rand_val < 10 ? '0' + rand_val : 'a' + (rand_val - 10);
-                ss << hex_digit;
+                os << (i == 0 ? "" : ", ") << "\"" << phase_names[i] << "\": {\"calls\": " << phase[i].calls.load(std::memory_order_relaxed)
+                   << ", \"nanoseconds\": " << phase[i].nanoseconds.load(std::memory_order_relaxed) << "}";
             }
-            m_uuid = ss.str();
+            return os << "}}";
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const Stats &stats)
+        {
+            return stats.print(os);
         }
 
-        operator std::string() const { return m_uuid; }
+        // adds the lifetime of the timer to a phase
+        class timer
+        {
+        public:
+            timer(Stats &stats, Phase phase) : m_stats{stats.phase[phase]}, m_start{std::chrono::steady_clock::now()} {}
+            timer(const timer &other) = delete;
+            timer &operator=(const timer &other) = delete;
+            ~timer()
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+                m_stats.calls.fetch_add(1, std::memory_order_relaxed);
+                m_stats.nanoseconds.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+            }
+
+        private:
+            phase_stats &m_stats;
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        // memory resource that counts what it forwards to upstream
+        class counting_resource : public std::pmr::memory_resource
+        {
+        public:
+            counting_resource(std::pmr::memory_resource *upstream, Stats &stats) : m_upstream{upstream}, m_stats{stats} {}
+
+            std::pmr::memory_resource *upstream() const { return m_upstream; }
+
+        private:
+            void *do_allocate(size_t bytes, size_t alignment) override
+            {
+                void *pointer = m_upstream->allocate(bytes, alignment);
+                m_stats.allocations.fetch_add(1, std::memory_order_relaxed);
+                m_stats.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                return pointer;
+            }
+            void do_deallocate(void *pointer, size_t bytes, size_t alignment) override
+            {
+                m_stats.deallocations.fetch_add(1, std::memory_order_relaxed);
+                m_upstream->deallocate(pointer, bytes, alignment);
+            }
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+            {
+                return this == &other;
+            }
+
+            std::pmr::memory_resource *m_upstream;
+            Stats &m_stats;
+        };
 
-        auto operator<=>(const uuid &other) const
+        // what the data structures return without SGL_INSTRUMENT, never
+        // written to
+        static Stats &none()
         {
-            return m_uuid <=> other.m_uuid;
+            static Stats stats;
+            return stats;
         }
+    };
+
+    class uuid
+    {
+    public:
+        struct hash
+        {
+            size_t operator()(const uuid &id) const
+            {
+                return static_cast<size_t>(id.m_high ^ (id.m_low * 0x9e3779b97f4a7c15ULL));
+            }
+        };
 
-        auto operator==(const uuid &other) const
+        constexpr uuid() = default;
+        constexpr uuid(std::uint64_t high, std::uint64_t low) : m_high{high}, m_low{low} {}
+
+        operator std::string() const
         {
-            return m_uuid == other.m_uuid;
+            constexpr char digits[] = "0123456789abcdef";
+
+            std::string str(32, '0');
+            for (int i = 0; i < 16; ++i)
+            {
+                str[15 - i] = digits[(m_high >> (4 * i)) & 0xf];
+                str[31 - i] = digits[(m_low >> (4 * i)) & 0xf];
+            }
+            return str;
         }
 
+        constexpr auto operator<=>(const uuid &other) const = default;
+        constexpr bool operator==(const uuid &other) const = default;
+
         friend std::ostream &operator<<(std::ostream &os, const uuid &uuid)
         {
-            return os << uuid.m_uuid;
+            return os << static_cast<std::string>(uuid);
         }
 
     private:
-        std::string m_uuid;
+        std::uint64_t m_high = 0;
+        std::uint64_t m_low = 0;
     };
 
-    template <typename DATA_TYPE>
+    class uuid_generator
+    {
+    public:
+        // seeded from std::random_device and a process wide counter, so that
+        // generators of different graphs never produce the same sequence
+        uuid_generator() : m_engine{random_seed()} {}
+        explicit uuid_generator(std::uint64_t seed) : m_engine{seed} {}
+
+        uuid operator()()
+        {
+            std::uint64_t high = m_engine();
+            std::uint64_t low = m_engine();
+            // the all-zero uuid is reserved for vertices not yet part of a graph
+            return high == 0 && low == 0 ? uuid{0, 1} : uuid{high, low};
+        }
+
+    private:
+        static std::uint64_t random_seed()
+        {
+            static std::atomic<std::uint64_t> counter{0};
+            std::random_device rd;
+            std::uint64_t seed = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+            return seed + 0x9e3779b97f4a7c15ULL * counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::mt19937_64 m_engine;
+    };
+
+    template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
     class Vertex
     {
-        using VERTEX_TYPE = Vertex<DATA_TYPE>;
+        using VERTEX_TYPE = Vertex<DATA_TYPE, DATA_STRUCTURE>;
+        using DATA_STRUCTURE_TYPE = DATA_STRUCTURE<DATA_TYPE>;
 
         friend class VertexPrinter;
-        friend class DataStructureBase<DATA_TYPE>;
-        friend class AdjacencyList<DATA_TYPE>;
-        friend class AdjacencyMatrix<DATA_TYPE>;
+        friend class DataStructureBase<DATA_TYPE, DATA_STRUCTURE>;
+        friend class DATA_STRUCTURE<DATA_TYPE>;
+        friend class io::MappedGraph<DATA_TYPE>;
 
     public:
-        Vertex(DATA_TYPE &&data) : m_uuid{}, m_data{std::move(data)}, m_data_structure{} {}
-        Vertex(DATA_TYPE &&data, std::shared_ptr<DataStructureBase<DATA_TYPE>> m_data_structure)
-            : m_uuid{}, m_data{std::move(data)}, m_data_structure{m_data_structure} {}
+        Vertex(DATA_TYPE &&data) : m_uuid{}, m_handle{}, m_data(std::move(data)), m_data_structure{nullptr} {}
+        Vertex(DATA_TYPE &&data, DATA_STRUCTURE_TYPE *data_structure)
+            : m_uuid{}, m_handle{}, m_data(std::move(data)), m_data_structure{data_structure} {}
         Vertex(const Vertex &other) = delete;
-        Vertex(Vertex &&other) : m_uuid{std::move(other.m_uuid)}, m_data{std::move(other.m_data)}, m_data_structure{std::move(other.m_data_structure)} {}
+        Vertex(Vertex &&other) : m_uuid{other.m_uuid}, m_handle{other.m_handle}, m_data(std::move(other.m_data)), m_data_structure{std::exchange(other.m_data_structure, nullptr)} {}
 
         ~Vertex() = default;
 
         const uuid &get_id() const { return m_uuid; }
+        vertex_handle get_handle() const { return m_handle; }
         const DATA_TYPE &data() const { return m_data; }
         DATA_TYPE &data() { return m_data; }
 
-        typename DataStructureBase<DATA_TYPE>::const_iterator begin() const { return m_data_structure->cbegin(m_uuid); }
-        typename DataStructureBase<DATA_TYPE>::const_iterator end() const { return m_data_structure->cend(m_uuid); }
-        typename DataStructureBase<DATA_TYPE>::iterator begin() { return m_data_structure->begin(m_uuid); }
-        typename DataStructureBase<DATA_TYPE>::iterator end() { return m_data_structure->end(m_uuid); }
+        typename DATA_STRUCTURE_TYPE::const_neighbor_iterator begin() const { return m_data_structure->cbegin(m_handle); }
+        typename DATA_STRUCTURE_TYPE::const_neighbor_iterator end() const { return m_data_structure->cend(m_handle); }
+        typename DATA_STRUCTURE_TYPE::neighbor_iterator begin() { return m_data_structure->begin(m_handle); }
+        typename DATA_STRUCTURE_TYPE::neighbor_iterator end() { return m_data_structure->end(m_handle); }
 
-        size_t size() const { return m_data_structure->size(m_uuid); }
+        size_t size() const { return m_data_structure->size(m_handle); }
 
         void remove()
         {
@@ -154,8 +412,8 @@ namespace sgl
                 throw std::runtime_error("[void sgl::Vertex::remove()] Vertex is not part of a graph");
             }
 
-            m_data_structure->remove_vertex(m_uuid);
-            m_data_structure = nullptr;
+            // removing the vertex destroys it, so nothing may be accessed afterwards
+            m_data_structure->remove_vertex(m_handle);
         }
 
         void remove_edge(const uuid &id)
@@ -163,7 +421,7 @@ namespace sgl
             if (m_data_structure == nullptr)
                 throw std::runtime_error("[void sgl::Vertex::remove_edge(const uuid &id)] Vertex is not part of a graph");
 
-            m_data_structure->remove_edge(m_uuid, id);
+            m_data_structure->remove_edge(m_handle, m_data_structure->handle(id));
         }
 
         friend std::ostream &operator<<(std::ostream &os, const VERTEX_TYPE &vertex)
@@ -173,14 +431,16 @@ namespace sgl
         }
 
     private:
-        void add_data_structure(const std::shared_ptr<DataStructureBase<DATA_TYPE>> &data_structure)
+        void add_data_structure(DATA_STRUCTURE_TYPE *data_structure)
         {
             m_data_structure = data_structure;
         }
 
-        const uuid m_uuid;
+        uuid m_uuid;
+        vertex_handle m_handle;
         DATA_TYPE m_data;
-        std::shared_ptr<DataStructureBase<DATA_TYPE>> m_data_structure;
+        // the data structure owns its vertices, so this is never dangling
+        DATA_STRUCTURE_TYPE *m_data_structure;
     };
 
     class VertexPrinter
@@ -189,8 +449,8 @@ namespace sgl
         VertexPrinter(std::ostream &os, VertexFormat format)
             : m_os{os}, m_format{format} {}
 
-        template <typename DATA_TYPE>
-        std::ostream &operator<<(const Vertex<DATA_TYPE> &vertex) const
+        template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
+        std::ostream &operator<<(const Vertex<DATA_TYPE, DATA_STRUCTURE> &vertex) const
         {
             if (m_format == VertexFormat::SHORTEST)
             {
@@ -211,7 +471,7 @@ namespace sgl
                 m_os << "}, neighbors: {";
                 for (auto it = vertex.begin(); it != vertex.end(); ++it)
                 {
-                    if (it == --vertex.end())
+                    if (std::next(it) == vertex.end())
                     {
                         m_os << *it;
                     }
@@ -262,7 +522,7 @@ namespace sgl
                 {
                     VertexPrinter{m_os, VertexFormat::LONG} << *it;
                 }
-                if (it != --adjacency_list.cend())
+                if (std::next(it) != adjacency_list.cend())
                 {
                     m_os << std::endl;
                 }
@@ -287,7 +547,32 @@ namespace sgl
                 {
                     VertexPrinter{m_os, VertexFormat::LONG} << *it;
                 }
-                if (it != --adjacency_matrix.cend())
+                if (std::next(it) != adjacency_matrix.cend())
+                {
+                    m_os << std::endl;
+                }
+            }
+            return m_os;
+        }
+
+        template <typename DATA_TYPE>
+        std::ostream &operator<<(const CSRGraph<DATA_TYPE> &csr_graph) const
+        {
+            for (auto it = csr_graph.cbegin(); it != csr_graph.cend(); ++it)
+            {
+                if (m_format == VertexFormat::SHORTEST)
+                {
+                    VertexPrinter{m_os, VertexFormat::SHORTEST} << *it;
+                }
+                else if (m_format == VertexFormat::SHORT)
+                {
+                    VertexPrinter{m_os, VertexFormat::SHORT} << *it;
+                }
+                else if (m_format == VertexFormat::LONG)
+                {
+                    VertexPrinter{m_os, VertexFormat::LONG} << *it;
+                }
+                if (std::next(it) != csr_graph.cend())
                 {
                     m_os << std::endl;
                 }
@@ -305,651 +590,765 @@ namespace sgl
         return VertexPrinter{os, format};
     }
 
-    template <typename DATA_TYPE>
+    template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
     class DataStructureBase
     {
-        using VERTEX_TYPE = Vertex<DATA_TYPE>;
+        using VERTEX_TYPE = Vertex<DATA_TYPE, DATA_STRUCTURE>;
 
-        friend class Vertex<DATA_TYPE>;
+        friend class Vertex<DATA_TYPE, DATA_STRUCTURE>;
 
     public:
-        DataStructureBase() = default;
-        virtual ~DataStructureBase() = default;
+        template <bool IS_CONST>
+        class basic_vertex_iterator;
+
+        using iterator = basic_vertex_iterator<false>;
+        using const_iterator = basic_vertex_iterator<true>;
+
+        explicit DataStructureBase(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+#if SGL_INSTRUMENT
+            : m_counting_resource{resource, m_stats}, m_resource{&m_counting_resource},
+#else
+            : m_resource{resource},
+#endif
+              m_vertices{m_resource}, m_free_handles{m_resource}, m_index{m_resource}, m_slabs{m_resource}
+        {
+        }
+        DataStructureBase(const DataStructureBase &other) = delete;
+        DataStructureBase &operator=(const DataStructureBase &other) = delete;
+        virtual ~DataStructureBase()
+        {
+            clear_vertices();
+            for (size_t slab = 0; slab < m_slabs.size(); ++slab)
+            {
+                std::pmr::polymorphic_allocator<VERTEX_TYPE>{m_resource}.deallocate(m_slabs[slab], slab_size(slab));
+            }
+        }
 
         virtual const uuid &add_vertex(VERTEX_TYPE &&vertex) = 0;
         virtual const uuid &add_vertex(DATA_TYPE &&data) = 0;
-        virtual void add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0) = 0;
-        virtual void remove_vertex(const uuid &vertex) = 0;
-        virtual void remove_edge(const uuid &vertex1, const uuid &vertex2) = 0;
+        virtual void add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0) = 0;
+        virtual void remove_vertex(vertex_handle vertex) = 0;
+        virtual void remove_edge(vertex_handle vertex1, vertex_handle vertex2) = 0;
+
+        // batch versions of add_edge and remove_vertex, either the whole batch
+        // is applied or the graph is left unchanged
+        virtual void add_edges(std::vector<Edge> edges, DuplicatePolicy policy = DuplicatePolicy::REJECT) = 0;
+        virtual void remove_vertices(std::vector<vertex_handle> vertices) = 0;
 
-        virtual const VERTEX_TYPE &vertex(const uuid &id) const = 0;
-        virtual VERTEX_TYPE &vertex(const uuid &id) = 0;
-        virtual const float &weight(const uuid &vertex1, const uuid &vertex2) const = 0;
-        virtual float &weight(const uuid &vertex1, const uuid &vertex2) = 0;
+        virtual const float &weight(vertex_handle vertex1, vertex_handle vertex2) const = 0;
+        virtual float &weight(vertex_handle vertex1, vertex_handle vertex2) = 0;
 
-        virtual size_t size() const = 0;
-        virtual size_t size(const uuid &id) const = 0;
+        virtual size_t size(vertex_handle vertex) const = 0;
         virtual void clear() = 0;
 
-        virtual std::ostream &print(std::ostream &os = std::cout) const = 0;
+        // edges is the expected number of edges, a hint for data structures
+        // that store them per vertex
+        virtual void reserve(size_t vertices, size_t edges) = 0;
+        virtual void shrink_to_fit() = 0;
 
-    protected:
-        class const_iterator_impl
-        {
-        public:
-            const_iterator_impl() = default;
-            virtual ~const_iterator_impl() = default;
-
-            virtual bool operator==(const const_iterator_impl *other) const = 0;
-            virtual bool operator!=(const const_iterator_impl *other) const = 0;
-            virtual const_iterator_impl *operator++() = 0;
-            virtual const_iterator_impl *operator--() = 0;
-            virtual const VERTEX_TYPE &operator*() const = 0;
-            virtual const VERTEX_TYPE *operator->() const = 0;
-        };
+        virtual std::ostream &print(std::ostream &os = std::cout) const = 0;
 
-        class iterator_impl
-        {
-        public:
-            iterator_impl() = default;
-            virtual ~iterator_impl() = default;
-
-            virtual bool operator==(const iterator_impl *other) const = 0;
-            virtual bool operator!=(const iterator_impl *other) const = 0;
-            virtual iterator_impl *operator++() = 0;
-            virtual iterator_impl *operator--() = 0;
-            virtual VERTEX_TYPE &operator*() const = 0;
-            virtual VERTEX_TYPE *operator->() const = 0;
-        };
+        // the uuid of a vertex is only used to look up its handle, everything
+        // else works on handles
+        void add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0) { add_edge(handle(vertex1), handle(vertex2), weight); }
+        void remove_vertex(const uuid &vertex) { remove_vertex(handle(vertex)); }
+        void remove_edge(const uuid &vertex1, const uuid &vertex2) { remove_edge(handle(vertex1), handle(vertex2)); }
+        const float &weight(const uuid &vertex1, const uuid &vertex2) const { return weight(handle(vertex1), handle(vertex2)); }
+        float &weight(const uuid &vertex1, const uuid &vertex2) { return weight(handle(vertex1), handle(vertex2)); }
+        size_t size(const uuid &id) const { return size(handle(id)); }
 
-    public:
-        class const_iterator
+        vertex_handle handle(const uuid &id) const
         {
-        public:
-            const_iterator(const std::shared_ptr<const_iterator_impl> &ptr) : m_ptr{ptr} {}
-            ~const_iterator() = default;
-
-            bool operator==(const const_iterator &other) const { return *m_ptr == other.m_ptr.get(); }
-            bool operator!=(const const_iterator &other) const { return *m_ptr != other.m_ptr.get(); }
-            const_iterator &operator++()
+            SGL_COUNT(m_stats, lookups, 1);
+            auto it = m_index.find(id);
+            if (it == m_index.end())
             {
-                ++(*m_ptr);
-                return *this;
-            }
-            const_iterator &operator--()
-            {
-                --(*m_ptr);
-                return *this;
+                throw std::out_of_range{"[vertex_handle sgl::DataStructureBase::handle(const uuid &id) const] Vertex with id " + static_cast<std::string>(id) + " not found"};
             }
-            const VERTEX_TYPE &operator*() const { return **m_ptr; }
-            const VERTEX_TYPE *operator->() const { return (*m_ptr).operator->(); }
+            return it->second;
+        }
 
-        private:
-            std::shared_ptr<const_iterator_impl> m_ptr;
-        };
+        bool contains(vertex_handle handle) const { return handle < m_vertices.size() && m_vertices[handle] != nullptr; }
 
-        class iterator
+        const VERTEX_TYPE &vertex(const uuid &id) const { return *m_vertices[handle(id)]; }
+        VERTEX_TYPE &vertex(const uuid &id) { return *m_vertices[handle(id)]; }
+        const VERTEX_TYPE &vertex(vertex_handle handle) const
         {
-        public:
-            iterator(const std::shared_ptr<iterator_impl> &ptr) : m_ptr{ptr} {}
-            ~iterator() = default;
-
-            bool operator==(const iterator &other) const { return *m_ptr == other.m_ptr.get(); }
-            bool operator!=(const iterator &other) const { return *m_ptr != other.m_ptr.get(); }
-            iterator &operator++()
+            if (!contains(handle))
             {
-                ++(*m_ptr);
-                return *this;
+                throw std::out_of_range{"[const VERTEX_TYPE &sgl::DataStructureBase::vertex(vertex_handle handle) const] Vertex with handle " + std::to_string(handle) + " not found"};
             }
-            iterator &operator--()
+            return *m_vertices[handle];
+        }
+        VERTEX_TYPE &vertex(vertex_handle handle)
+        {
+            if (!contains(handle))
             {
-                --(*m_ptr);
-                return *this;
+                throw std::out_of_range{"[VERTEX_TYPE &sgl::DataStructureBase::vertex(vertex_handle handle)] Vertex with handle " + std::to_string(handle) + " not found"};
             }
-            VERTEX_TYPE &operator*() const { return **m_ptr; }
-            VERTEX_TYPE *operator->() const { return (*m_ptr).operator->(); }
-
-        private:
-            std::shared_ptr<iterator_impl> m_ptr;
-        };
-
-        virtual const_iterator cbegin() const = 0;
-        virtual const_iterator cend() const = 0;
-        virtual iterator begin() = 0;
-        virtual iterator end() = 0;
-
-        virtual const_iterator cbegin(const uuid &id) const = 0;
-        virtual const_iterator cend(const uuid &id) const = 0;
-        virtual iterator begin(const uuid &id) = 0;
-        virtual iterator end(const uuid &id) = 0;
-    };
-
-    template <typename DATA_TYPE>
-    class AdjacencyList : public DataStructureBase<DATA_TYPE>, public std::enable_shared_from_this<AdjacencyList<DATA_TYPE>>
-    {
-    public:
-        ~AdjacencyList() = default;
-
-    private:
-        using VERTEX_TYPE = Vertex<DATA_TYPE>;
-
-        using base_iterator_impl =
-            typename DataStructureBase<DATA_TYPE>::iterator_impl;
-
-        using base_iterator = typename DataStructureBase<DATA_TYPE>::iterator;
-
-        using base_const_iterator_impl =
-            typename DataStructureBase<DATA_TYPE>::const_iterator_impl;
-
-        using base_const_iterator =
-            typename DataStructureBase<DATA_TYPE>::const_iterator;
-
-        using const_neighbor_iterator =
-            typename std::vector<std::pair<uuid, float>>::const_iterator;
-
-        using neighbor_iterator =
-            typename std::vector<std::pair<uuid, float>>::iterator;
+            return *m_vertices[handle];
+        }
 
-        using const_vertex_iterator =
-            typename std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>>::const_iterator;
+        size_t size() const { return m_index.size(); }
+
+        // one past the largest handle in use, handles of removed vertices are
+        // reused by later insertions
+        vertex_handle handle_bound() const { return static_cast<vertex_handle>(m_vertices.size()); }
+
+#if SGL_INSTRUMENT
+        std::pmr::memory_resource *resource() const { return m_counting_resource.upstream(); }
+        Stats &stats() const { return m_stats; }
+#else
+        std::pmr::memory_resource *resource() const { return m_resource; }
+        Stats &stats() const { return Stats::none(); }
+#endif
+
+        const_iterator cbegin() const { return const_iterator{m_vertices.data(), m_vertices.data() + m_vertices.size()}; }
+        const_iterator cend() const { return const_iterator{m_vertices.data() + m_vertices.size(), m_vertices.data() + m_vertices.size()}; }
+        const_iterator begin() const { return cbegin(); }
+        const_iterator end() const { return cend(); }
+        iterator begin() { return iterator{m_vertices.data(), m_vertices.data() + m_vertices.size()}; }
+        iterator end() { return iterator{m_vertices.data() + m_vertices.size(), m_vertices.data() + m_vertices.size()}; }
+
+        // Vertex iteration is shared by every data structure, neighbor iteration
+        // is not part of the virtual interface. Every data structure defines its
+        // own neighbor_iterator and const_neighbor_iterator which refer to the
+        // owning container instead of copying it and model std::forward_iterator,
+        // together with begin(), end(), cbegin(), cend() (vertex_handle vertex).
+
+        template <bool IS_CONST>
+        class basic_vertex_iterator
+        {
+            using storage_pointer = VERTEX_TYPE *const *;
 
-        using vertex_iterator =
-            typename std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>>::iterator;
+            friend class DataStructureBase;
 
-        friend class BFS<AdjacencyList<DATA_TYPE>>;
-        friend class DFS<AdjacencyList<DATA_TYPE>>;
-        friend class Graph<DATA_TYPE, AdjacencyList>;
-        friend class VertexPrinter;
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = VERTEX_TYPE;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IS_CONST, const VERTEX_TYPE *, VERTEX_TYPE *>;
+            using reference = std::conditional_t<IS_CONST, const VERTEX_TYPE &, VERTEX_TYPE &>;
 
-        std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>> m_vertices;
+            basic_vertex_iterator() = default;
 
-        AdjacencyList() = default;
+            reference operator*() const { return **m_it; }
+            pointer operator->() const { return *m_it; }
 
-        const uuid &add_vertex(VERTEX_TYPE &&vertex) override
-        {
-            auto new_vertex = std::make_shared<VERTEX_TYPE>(std::forward<VERTEX_TYPE>(vertex));
-            new_vertex->add_data_structure(this->shared_from_this());
-            const uuid &id = new_vertex->get_id();
-            m_vertices.insert(std::make_pair(
-                id,
-                std::make_pair(std::move(new_vertex),
-                               std::vector<std::pair<uuid, float>>())));
-            return id;
-        }
+            basic_vertex_iterator &operator++()
+            {
+                ++m_it;
+                skip_free_handles();
+                return *this;
+            }
+            basic_vertex_iterator operator++(int)
+            {
+                basic_vertex_iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
 
-        const uuid &add_vertex(DATA_TYPE &&data) override
-        {
-            VERTEX_TYPE vertex{std::forward<DATA_TYPE>(data)};
-            return add_vertex(std::move(vertex));
-        }
+            bool operator==(const basic_vertex_iterator &other) const { return m_it == other.m_it; }
 
-        void add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0) override
-        {
-            if (vertex1 == vertex2)
+        private:
+            basic_vertex_iterator(storage_pointer it, storage_pointer end) : m_it{it}, m_end{end}
             {
-                throw std::invalid_argument("[void sgl::AdjacencyList::add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0)] vertex1 and vertex2 must be different");
+                skip_free_handles();
             }
 
-            // check if edge already exists
-            for (auto &neighbor : m_vertices.at(vertex1).second)
+            void skip_free_handles()
             {
-                if (neighbor.first == vertex2)
+                while (m_it != m_end && *m_it == nullptr)
                 {
-                    throw std::invalid_argument("[void sgl::AdjacencyList::add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0)] Edge between vertex with id " + static_cast<std::string>(vertex1) + " and vertex with id " + static_cast<std::string>(vertex2) + " already exists");
+                    ++m_it;
                 }
             }
 
+            storage_pointer m_it = nullptr;
+            storage_pointer m_end = nullptr;
+        };
+
+    public:
+        // adds a vertex for every element of data, returns their ids in the
+        // same order
+        template <typename RANGE>
+        std::vector<uuid> add_vertices(const RANGE &data)
+        {
+            // copy everything first so a throwing copy leaves the graph alone,
+            // and reserve so that rolling back cannot fail
+            std::vector<DATA_TYPE> copies(std::ranges::begin(data), std::ranges::end(data));
+            std::vector<uuid> ids;
+            ids.reserve(copies.size());
+            reserve_vertices(size() + copies.size());
+            m_free_handles.reserve(m_free_handles.size() + copies.size());
+
             try
             {
-                m_vertices.at(vertex1).second.push_back(std::pair{vertex2, weight});
-                m_vertices.at(vertex2).second.push_back(std::pair{vertex1, weight});
+                for (auto &copy : copies)
+                {
+                    ids.push_back(add_vertex(std::move(copy)));
+                }
             }
-            catch (const std::out_of_range &e)
+            catch (...)
             {
-                throw std::out_of_range{"[void sgl::AdjacencyList::add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0)] Vertex with id " + static_cast<std::string>(vertex1) + " or " + static_cast<std::string>(vertex2) + " not found"};
+                for (auto it = ids.rbegin(); it != ids.rend(); ++it)
+                {
+                    remove_vertex(handle(*it));
+                }
+                throw;
             }
+            return ids;
         }
 
-        void remove_vertex(const uuid &vertex) override
+    protected:
+        void check_edges(const std::vector<Edge> &edges) const
         {
-            if (m_vertices.find(vertex) == m_vertices.end())
-            {
-                throw std::out_of_range{"[void sgl::AdjacencyList::remove_vertex(const uuid &vertex) override] Vertex with id " + static_cast<std::string>(vertex) + " not found"};
-            }
-
-            auto &neighbors = m_vertices[vertex].second;
-            for (auto &neighbor : neighbors)
+            for (auto &edge : edges)
             {
-                auto &neighbor_neighbors = m_vertices[neighbor.first].second;
-                neighbor_neighbors.erase(
-                    std::remove_if(
-                        neighbor_neighbors.begin(), neighbor_neighbors.end(),
-                        [vertex](const std::pair<uuid, float> &neighbor_neighbor)
-                        {
-                            return neighbor_neighbor.first == vertex;
-                        }),
-                    neighbor_neighbors.end());
+                if (edge.vertex1 == edge.vertex2)
+                {
+                    throw std::invalid_argument("[void sgl::DataStructureBase::check_edges(const std::vector<Edge> &edges) const] vertex1 and vertex2 must be different");
+                }
+                if (!contains(edge.vertex1) || !contains(edge.vertex2))
+                {
+                    throw std::out_of_range{"[void sgl::DataStructureBase::check_edges(const std::vector<Edge> &edges) const] Vertex with handle " + std::to_string(edge.vertex1) + " or " + std::to_string(edge.vertex2) + " not found"};
+                }
             }
-            m_vertices.erase(vertex);
         }
 
-        void remove_edge(const uuid &vertex1, const uuid &vertex2) override
+        // Checks a batch of vertices to remove, drops repeated handles and
+        // makes room for their handles in m_free_handles, so erase_vertex does
+        // not throw for them.
+        void prepare_vertices(std::vector<vertex_handle> &vertices)
         {
-            if (vertex1 == vertex2)
+            for (auto &vertex : vertices)
             {
-                throw std::invalid_argument("[void sgl::AdjacencyList::remove_edge(const uuid &vertex1, const uuid &vertex2)] vertex1 and vertex2 must be different");
+                if (!contains(vertex))
+                {
+                    throw std::out_of_range{"[void sgl::DataStructureBase::prepare_vertices(std::vector<vertex_handle> &vertices)] Vertex with handle " + std::to_string(vertex) + " not found"};
+                }
             }
+            std::sort(vertices.begin(), vertices.end());
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+            m_free_handles.reserve(m_free_handles.size() + vertices.size());
+        }
 
-            if (m_vertices.find(vertex1) == m_vertices.end())
+        // moves the vertex into its slot, assigns it a handle and interns its
+        // uuid, generating one if the vertex has none yet
+        VERTEX_TYPE &insert_vertex(VERTEX_TYPE &&vertex)
+        {
+            uuid id = vertex.m_uuid;
+            if (id == uuid{})
             {
-                throw std::out_of_range{"[void sgl::AdjacencyList::remove_edge(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex1) + " not found"};
+                do
+                {
+                    id = m_generator();
+                } while (m_index.contains(id));
             }
-
-            if (m_vertices.find(vertex2) == m_vertices.end())
+            else if (m_index.contains(id))
             {
-                throw std::out_of_range{"[void sgl::AdjacencyList::remove_edge(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+                throw std::invalid_argument{"[VERTEX_TYPE &sgl::DataStructureBase::insert_vertex(VERTEX_TYPE &&vertex)] Vertex with id " + static_cast<std::string>(id) + " already exists"};
             }
 
-            auto &neighbors = m_vertices[vertex1].second;
-            neighbors.erase(
-                std::remove_if(neighbors.begin(), neighbors.end(),
-                               [vertex2](const std::pair<uuid, float> &neighbor)
-                               {
-                                   return neighbor.first == vertex2;
-                               }),
-                neighbors.end());
-
-            auto &neighbors2 = m_vertices[vertex2].second;
-            neighbors2.erase(
-                std::remove_if(neighbors2.begin(), neighbors2.end(),
-                               [vertex1](const std::pair<uuid, float> &neighbor)
-                               {
-                                   return neighbor.first == vertex1;
-                               }),
-                neighbors2.end());
-        }
+            const bool new_handle = m_free_handles.empty();
+            const vertex_handle handle = new_handle ? static_cast<vertex_handle>(m_vertices.size()) : m_free_handles.back();
+            VERTEX_TYPE *slot = allocate_slot(handle);
 
-        template <typename FUNCTION, typename... ARGS>
-        void remove_if(FUNCTION &&function, ARGS &&...args)
-        {
-            if constexpr (!std::is_same_v<
-                              bool, std::invoke_result_t<FUNCTION, const VERTEX_TYPE &,
-                                                         ARGS...>>)
+            if (new_handle)
             {
-                throw std::invalid_argument("[void sgl::AdjacencyList::remove_if(FUNCTION &&function, ARGS &&...args)] return type of function must be bool");
+                m_vertices.push_back(nullptr);
             }
-            else
+            try
             {
-                std::vector<uuid> to_remove;
-                for (auto it = cbegin(); it != cend(); ++it)
+                m_index.emplace(id, handle);
+                try
                 {
-                    if (function(*it, std::forward<ARGS>(args)...))
-                    {
-                        to_remove.push_back(it->get_id());
-                    }
+                    std::construct_at(slot, std::forward<VERTEX_TYPE>(vertex));
                 }
-                for (auto &id : to_remove)
+                catch (...)
                 {
-                    remove_vertex(id);
+                    m_index.erase(id);
+                    throw;
                 }
             }
-        }
+            catch (...)
+            {
+                if (new_handle)
+                {
+                    m_vertices.pop_back();
+                }
+                throw;
+            }
 
-        const VERTEX_TYPE &vertex(const uuid &id) const override
-        {
-            return *m_vertices.at(id).first;
+            if (!new_handle)
+            {
+                m_free_handles.pop_back();
+            }
+            slot->m_uuid = id;
+            slot->m_handle = handle;
+            m_vertices[handle] = slot;
+            return *slot;
         }
-        VERTEX_TYPE &vertex(const uuid &id) override
+
+        void erase_vertex(vertex_handle handle)
         {
-            return *m_vertices.at(id).first;
+            m_free_handles.push_back(handle);
+            m_index.erase(m_vertices[handle]->m_uuid);
+            std::destroy_at(m_vertices[handle]);
+            m_vertices[handle] = nullptr;
         }
 
-        const float &weight(const uuid &vertex1, const uuid &vertex2) const override
+        // replaces the contents with a copy of another graph, keeping the uuids
+        // of its vertices
+        template <typename OTHER_GRAPH>
+        void assign(const OTHER_GRAPH &other)
         {
-            if (vertex1 == vertex2)
-            {
-                throw std::invalid_argument("[const float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2) const] vertex1 and vertex2 must be different");
-            }
-
-            if (m_vertices.find(vertex1) == m_vertices.end())
-            {
-                throw std::out_of_range{"[const float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2) const] Vertex with id " + static_cast<std::string>(vertex1) + " not found"};
-            }
+            clear();
+            reserve(other.size(), 0);
 
-            if (m_vertices.find(vertex2) == m_vertices.end())
+            std::vector<vertex_handle> handles(other.handle_bound());
+            for (auto &vertex : other)
             {
-                throw std::out_of_range{"[const float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2) const] Vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+                VERTEX_TYPE copy{DATA_TYPE(vertex.data())};
+                copy.m_uuid = vertex.get_id();
+                handles[vertex.get_handle()] = handle(add_vertex(std::move(copy)));
             }
 
-            for (auto &neighbor : m_vertices.at(vertex1).second)
+            for (auto &vertex : other)
             {
-                if (neighbor.first == vertex2)
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
                 {
-                    return neighbor.second;
+                    if (vertex.get_handle() < it.handle())
+                    {
+                        add_edge(handles[vertex.get_handle()], handles[it.handle()], it.weight());
+                    }
                 }
             }
-
-            throw std::out_of_range{"[const float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2) const] Edge between vertex with id " + static_cast<std::string>(vertex1) + " and vertex with id " + static_cast<std::string>(vertex2) + " not found"};
         }
 
-        float &weight(const uuid &vertex1, const uuid &vertex2) override
+        // the slabs are kept, so a cleared graph refills the same memory
+        void clear_vertices()
         {
-            if (vertex1 == vertex2)
+            for (auto &vertex : m_vertices)
             {
-                throw std::invalid_argument("[float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2)] vertex1 and vertex2 must be different");
+                if (vertex != nullptr)
+                {
+                    std::destroy_at(vertex);
+                }
             }
+            m_vertices.clear();
+            m_free_handles.clear();
+            m_index.clear();
+        }
 
-            if (m_vertices.find(vertex1) == m_vertices.end())
+        void reserve_vertices(size_t vertices)
+        {
+            m_vertices.reserve(vertices);
+            m_index.reserve(vertices);
+            if (vertices > 0)
             {
-                throw std::out_of_range{"[float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex1) + " not found"};
+                allocate_slot(static_cast<vertex_handle>(vertices - 1));
             }
+        }
 
-            if (m_vertices.find(vertex2) == m_vertices.end())
+        // drops trailing free handles and the slabs and capacity they used
+        void shrink_vertices()
+        {
+            while (!m_vertices.empty() && m_vertices.back() == nullptr)
             {
-                throw std::out_of_range{"[float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+                m_vertices.pop_back();
             }
+            std::erase_if(m_free_handles, [this](vertex_handle handle)
+                          { return handle >= m_vertices.size(); });
 
-            for (auto &neighbor : m_vertices.at(vertex1).second)
+            const size_t slabs = m_vertices.empty() ? 0 : slab_of(static_cast<vertex_handle>(m_vertices.size() - 1)) + 1;
+            while (m_slabs.size() > slabs)
             {
-                if (neighbor.first == vertex2)
-                {
-                    return neighbor.second;
-                }
+                std::pmr::polymorphic_allocator<VERTEX_TYPE>{m_resource}.deallocate(m_slabs.back(), slab_size(m_slabs.size() - 1));
+                m_slabs.pop_back();
             }
 
-            throw std::out_of_range{"[float& sgl::AdjacencyList::weight(const uuid &vertex1, const uuid &vertex2)] Edge between vertex with id " + static_cast<std::string>(vertex1) + " and vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+            m_vertices.shrink_to_fit();
+            m_free_handles.shrink_to_fit();
+            m_slabs.shrink_to_fit();
+            m_index.rehash(0);
         }
 
-        size_t size() const override { return m_vertices.size(); }
-        size_t size(const uuid &id) const override
-        {
-            return m_vertices.at(id).second.size();
-        }
-        void clear() override { m_vertices.clear(); }
+#if SGL_INSTRUMENT
+        // counts what the storage below allocates from the resource of the
+        // graph, m_resource points to it
+        mutable Stats m_stats;
+        Stats::counting_resource m_counting_resource;
+#endif
+        std::pmr::memory_resource *m_resource;
 
-        std::ostream &print(std::ostream &os = std::cout) const override
+        // handle -> vertex, nullptr for free handles
+        std::pmr::vector<VERTEX_TYPE *> m_vertices;
+        std::pmr::vector<vertex_handle> m_free_handles;
+        std::pmr::unordered_map<uuid, vertex_handle, uuid::hash> m_index;
+        uuid_generator m_generator;
+
+    private:
+        // Vertices live in slabs allocated from m_resource, slab i holds
+        // first_slab_size << i vertices, so a handle always maps to the same
+        // slot and vertices never move while the graph grows.
+        static constexpr size_t first_slab_size = 64;
+
+        static size_t slab_of(vertex_handle handle) { return std::bit_width(handle / first_slab_size + 1) - 1; }
+        static size_t slab_begin(size_t slab) { return first_slab_size * ((size_t{1} << slab) - 1); }
+        static size_t slab_size(size_t slab) { return first_slab_size << slab; }
+
+        VERTEX_TYPE *allocate_slot(vertex_handle handle)
         {
-            for (auto it = cbegin(); it != cend(); ++it)
+            const size_t slab = slab_of(handle);
+            if (slab >= m_slabs.size())
             {
-                os << *it << std::endl;
+                m_slabs.reserve(slab + 1);
+                while (slab >= m_slabs.size())
+                {
+                    m_slabs.push_back(std::pmr::polymorphic_allocator<VERTEX_TYPE>{m_resource}.allocate(slab_size(m_slabs.size())));
+                }
             }
-            return os;
+            return m_slabs[slab] + (handle - slab_begin(slab));
         }
 
-        template <template <typename> typename ALGORITHM = BFS,
-                  VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
-                  typename... ARGS>
-        void traverse(const uuid &id, FUNCTION function, ARGS &&...args)
-        {
-            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
-            algorithm.template traverse<policy>(*this, id, function,
-                                                std::forward<ARGS>(args)...);
-        }
+        std::pmr::vector<VERTEX_TYPE *> m_slabs;
+    };
 
-        template <template <typename> typename ALGORITHM = BFS,
-                  VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
-                  typename... ARGS>
-        void traverse(FUNCTION function, ARGS &&...args)
-        {
-            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
-            const uuid &id = m_vertices.begin()->first;
-            algorithm.template traverse<policy>(*this, id, function,
-                                                std::forward<ARGS>(args)...);
-        }
+    template <typename DATA_TYPE>
+    class AdjacencyList : public DataStructureBase<DATA_TYPE, AdjacencyList>
+    {
+    public:
+        ~AdjacencyList() = default;
 
-        template <template <typename> typename ALGORITHM = BFS,
-                  VisitPolicy policy = VisitPolicy::RELATED>
-        void traverse(const uuid &id)
-        {
-            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
-            algorithm.template traverse<policy>(*this, id,
-                                                [](const Vertex<DATA_TYPE> &vertex)
-                                                {
-                                                    std::cout << vertex << std::endl;
-                                                });
-        }
+        template <bool IS_CONST>
+        class basic_neighbor_iterator;
 
-        template <template <typename> typename ALGORITHM = BFS,
-                  VisitPolicy policy = VisitPolicy::RELATED>
-        void traverse()
+        using neighbor_iterator = basic_neighbor_iterator<false>;
+        using const_neighbor_iterator = basic_neighbor_iterator<true>;
+
+    private:
+        using VERTEX_TYPE = Vertex<DATA_TYPE, AdjacencyList>;
+        using BASE_TYPE = DataStructureBase<DATA_TYPE, AdjacencyList>;
+
+        using edge_list = std::pmr::vector<std::pair<vertex_handle, float>>;
+
+        friend class BFS<AdjacencyList<DATA_TYPE>>;
+        friend class DFS<AdjacencyList<DATA_TYPE>>;
+        friend class ParallelBFS<AdjacencyList<DATA_TYPE>>;
+        friend class Graph<DATA_TYPE, AdjacencyList>;
+        friend class Vertex<DATA_TYPE, AdjacencyList>;
+        friend class VertexPrinter;
+
+        using BASE_TYPE::add_edge;
+        using BASE_TYPE::begin;
+        using BASE_TYPE::cbegin;
+        using BASE_TYPE::cend;
+        using BASE_TYPE::end;
+        using BASE_TYPE::remove_edge;
+        using BASE_TYPE::remove_vertex;
+        using BASE_TYPE::size;
+        using BASE_TYPE::weight;
+
+        using BASE_TYPE::m_vertices;
+
+        // neighbors of every vertex, indexed by vertex handle, the edge lists
+        // allocate from the same memory resource as m_edges
+        std::pmr::vector<edge_list> m_edges;
+        // expected number of neighbors per vertex, set by reserve
+        size_t m_degree_hint = 0;
+
+        explicit AdjacencyList(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : BASE_TYPE{resource}, m_edges{this->m_resource} {}
+
+        const uuid &add_vertex(VERTEX_TYPE &&vertex) override
         {
-            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
-            const uuid &id = m_vertices.begin()->first;
-            algorithm.template traverse<policy>(*this, id,
-                                                [](const Vertex<DATA_TYPE> &vertex)
-                                                {
-                                                    std::cout << vertex << std::endl;
-                                                });
+            // grow first so a failed allocation leaves the graph untouched, a
+            // reused handle has an empty edge list already
+            if (this->m_free_handles.empty() && m_edges.size() <= m_vertices.size())
+            {
+                m_edges.emplace_back().reserve(m_degree_hint);
+            }
+
+            VERTEX_TYPE &new_vertex = this->insert_vertex(std::forward<VERTEX_TYPE>(vertex));
+            new_vertex.add_data_structure(this);
+            return new_vertex.get_id();
         }
 
-        friend std::ostream &operator<<(std::ostream &os, const AdjacencyList &list)
+        const uuid &add_vertex(DATA_TYPE &&data) override
         {
-            return list.print(os);
+            VERTEX_TYPE vertex{std::forward<DATA_TYPE>(data)};
+            return add_vertex(std::move(vertex));
         }
 
-        base_const_iterator cbegin() const override { return base_const_iterator{std::make_shared<const_iterator<const_vertex_iterator>>(m_vertices.cbegin(), m_vertices)}; }
-        base_const_iterator cend() const override { return base_const_iterator{std::make_shared<const_iterator<const_vertex_iterator>>(m_vertices.cend(), m_vertices)}; }
-        base_iterator begin() override { return base_iterator{std::make_shared<iterator<vertex_iterator>>(m_vertices.begin(), m_vertices)}; }
-        base_iterator end() override { return base_iterator{std::make_shared<iterator<vertex_iterator>>(m_vertices.end(), m_vertices)}; }
-
-        base_const_iterator cbegin(const uuid &id) const override { return base_const_iterator{std::make_shared<const_iterator<const_neighbor_iterator>>(m_vertices.at(id).second.cbegin(), m_vertices)}; }
-        base_const_iterator cend(const uuid &id) const override { return base_const_iterator{std::make_shared<const_iterator<const_neighbor_iterator>>(m_vertices.at(id).second.cend(), m_vertices)}; }
-        base_iterator begin(const uuid &id) override { return base_iterator{std::make_shared<iterator<neighbor_iterator>>(m_vertices.at(id).second.begin(), m_vertices)}; }
-        base_iterator end(const uuid &id) override { return base_iterator{std::make_shared<iterator<neighbor_iterator>>(m_vertices.at(id).second.end(), m_vertices)}; }
-
-        template <typename ITERATOR>
-        class iterator : public base_iterator_impl
+        void add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0) override
         {
-        public:
-            iterator(const ITERATOR &it, std::map<uuid, std::pair<
-                                                            std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>>
-                                             vertices) : m_it{it}, m_vertices{vertices} {}
-            bool operator==(const base_iterator_impl *other) const override { return m_it == static_cast<const iterator *>(other)->m_it; }
-            bool operator!=(const base_iterator_impl *other) const override { return m_it != static_cast<const iterator *>(other)->m_it; }
-            base_iterator_impl *operator++() override
+            if (vertex1 == vertex2)
             {
-                ++m_it;
-                return this;
+                throw std::invalid_argument("[void sgl::AdjacencyList::add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)] vertex1 and vertex2 must be different");
             }
-            base_iterator_impl *operator--() override
+
+            if (!this->contains(vertex1) || !this->contains(vertex2))
             {
-                --m_it;
-                return this;
+                throw std::out_of_range{"[void sgl::AdjacencyList::add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)] Vertex with handle " + std::to_string(vertex1) + " or " + std::to_string(vertex2) + " not found"};
             }
-            VERTEX_TYPE &operator*() const override
+
+            // check if edge already exists
+            for (auto &neighbor : m_edges[vertex1])
             {
-                if constexpr (std::is_same_v<ITERATOR, vertex_iterator>)
-                {
-                    return *m_it->second.first;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, neighbor_iterator>)
+                if (neighbor.first == vertex2)
                 {
-                    return *m_vertices.at(m_it->first).first;
+                    throw std::invalid_argument("[void sgl::AdjacencyList::add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex1]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[vertex2]->get_id()) + " already exists");
                 }
             }
 
-            VERTEX_TYPE *operator->() const override
+            m_edges[vertex1].emplace_back(vertex2, weight);
+            try
             {
-                if constexpr (std::is_same_v<ITERATOR, vertex_iterator>)
-                {
-                    return m_it->second.first.get();
-                }
-                else if (std::is_same_v<ITERATOR, neighbor_iterator>)
-                {
-                    return m_vertices.at(m_it->first).first.get();
-                }
+                m_edges[vertex2].emplace_back(vertex1, weight);
             }
+            catch (...)
+            {
+                m_edges[vertex1].pop_back();
+                throw;
+            }
+        }
 
-        private:
-            ITERATOR m_it;
-            std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>> m_vertices;
-        };
-
-        template <typename ITERATOR>
-        class const_iterator : public base_const_iterator_impl
+        void remove_vertex(vertex_handle vertex) override
         {
-        public:
-            const_iterator(const ITERATOR &it, std::map<uuid, std::pair<
-                                                                  std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>>
-                                                   vertices) : m_it{it}, m_vertices{vertices} {}
-            bool operator==(const base_const_iterator_impl *other) const override { return m_it == static_cast<const const_iterator *>(other)->m_it; }
-            bool operator!=(const base_const_iterator_impl *other) const override { return m_it != static_cast<const const_iterator *>(other)->m_it; }
-            base_const_iterator_impl *operator++() override
+            if (!this->contains(vertex))
             {
-                ++m_it;
-                return this;
+                throw std::out_of_range{"[void sgl::AdjacencyList::remove_vertex(vertex_handle vertex)] Vertex with handle " + std::to_string(vertex) + " not found"};
             }
-            base_const_iterator_impl *operator--() override
+
+            for (auto &neighbor : m_edges[vertex])
             {
-                --m_it;
-                return this;
+                erase_neighbor(neighbor.first, vertex);
             }
-            const VERTEX_TYPE &operator*() const override
+            m_edges[vertex].clear();
+            this->erase_vertex(vertex);
+        }
+
+        void remove_edge(vertex_handle vertex1, vertex_handle vertex2) override
+        {
+            if (vertex1 == vertex2)
             {
-                if constexpr (std::is_same_v<ITERATOR, const_vertex_iterator>)
-                {
-                    return *m_it->second.first;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, const_neighbor_iterator>)
-                {
-                    return *m_vertices.at(m_it->first).first;
-                }
+                throw std::invalid_argument("[void sgl::AdjacencyList::remove_edge(vertex_handle vertex1, vertex_handle vertex2)] vertex1 and vertex2 must be different");
             }
 
-            const VERTEX_TYPE *operator->() const override
+            if (!this->contains(vertex1))
             {
-                if constexpr (std::is_same_v<ITERATOR, const_vertex_iterator>)
-                {
-                    return m_it->second.first.get();
-                }
-                else if constexpr (std::is_same_v<ITERATOR, const_neighbor_iterator>)
-                {
-                    return m_vertices.at(m_it->first).first.get();
-                }
+                throw std::out_of_range{"[void sgl::AdjacencyList::remove_edge(vertex_handle vertex1, vertex_handle vertex2)] Vertex with handle " + std::to_string(vertex1) + " not found"};
             }
 
-        private:
-            ITERATOR m_it;
-            std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::vector<std::pair<uuid, float>>>> m_vertices;
-        };
-    };
-
-    template <typename DATA_TYPE>
-    class AdjacencyMatrix : public DataStructureBase<DATA_TYPE>, public std::enable_shared_from_this<AdjacencyMatrix<DATA_TYPE>>
-    {
-    public:
-        ~AdjacencyMatrix() = default;
-
-    private:
-        using VERTEX_TYPE = Vertex<DATA_TYPE>;
-
-        using base_iterator_impl =
-            typename DataStructureBase<DATA_TYPE>::iterator_impl;
-
-        using base_iterator = typename DataStructureBase<DATA_TYPE>::iterator;
-
-        using base_const_iterator_impl =
-            typename DataStructureBase<DATA_TYPE>::const_iterator_impl;
-
-        using base_const_iterator =
-            typename DataStructureBase<DATA_TYPE>::const_iterator;
-
-        using const_neighbor_iterator =
-            typename std::map<uuid, float>::const_iterator;
-
-        using neighbor_iterator =
-            typename std::map<uuid, float>::iterator;
-
-        using const_vertex_iterator =
-            typename std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::map<uuid, float>>>::const_iterator;
-
-        using vertex_iterator =
-            typename std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::map<uuid, float>>>::iterator;
-
-        friend class BFS<AdjacencyMatrix<DATA_TYPE>>;
-        friend class DFS<AdjacencyMatrix<DATA_TYPE>>;
-        friend class Graph<DATA_TYPE, AdjacencyMatrix>;
-        friend class VertexPrinter;
-
-        std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>, std::map<uuid, float>>> m_vertices;
-
-        AdjacencyMatrix() = default;
-
-        const uuid &add_vertex(VERTEX_TYPE &&vertex) override
-        {
-            auto new_vertex = std::make_shared<VERTEX_TYPE>(std::forward<VERTEX_TYPE>(vertex));
-            new_vertex->add_data_structure(this->shared_from_this());
-            const uuid &id = new_vertex->get_id();
-
-            m_vertices.insert(std::make_pair(id, std::make_pair(std::move(new_vertex), std::map<uuid, float>{})));
-            for (auto &v : m_vertices)
+            if (!this->contains(vertex2))
             {
-                v.second.second.insert(std::make_pair(id, std::nanf("Not adjacent")));
-                m_vertices.at(id).second.insert(std::make_pair(v.first, std::nanf("Not adjacent")));
+                throw std::out_of_range{"[void sgl::AdjacencyList::remove_edge(vertex_handle vertex1, vertex_handle vertex2)] Vertex with handle " + std::to_string(vertex2) + " not found"};
             }
 
-            return id;
+            erase_neighbor(vertex1, vertex2);
+            erase_neighbor(vertex2, vertex1);
         }
 
-        const uuid &add_vertex(DATA_TYPE &&data) override
+        void erase_neighbor(vertex_handle vertex, vertex_handle neighbor)
         {
-            VERTEX_TYPE vertex{std::forward<DATA_TYPE>(data)};
-            return add_vertex(std::move(vertex));
+            auto &neighbors = m_edges[vertex];
+            neighbors.erase(
+                std::remove_if(neighbors.begin(), neighbors.end(),
+                               [neighbor](const std::pair<vertex_handle, float> &edge)
+                               {
+                                   return edge.first == neighbor;
+                               }),
+                neighbors.end());
         }
 
-        void add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0) override
+        // The edges are appended to the lists of both of their vertices
+        // without any checks, then the new part of every touched list is
+        // sorted once to find repeated and existing edges. Until the weights
+        // of existing edges are updated at the end, a failure only has to cut
+        // the new parts off.
+        void add_edges(std::vector<Edge> edges, DuplicatePolicy policy = DuplicatePolicy::REJECT) override
         {
-            if (vertex1 == vertex2)
+            this->check_edges(edges);
+
+            // touched vertices with the size of their list before the batch,
+            // in handle order so the lists are merged in memory order, taken
+            // from the batch so that its cost does not grow with the graph
+            std::vector<vertex_handle> touched;
+            touched.reserve(2 * edges.size());
+            for (auto &edge : edges)
             {
-                throw std::invalid_argument{"[void sgl::AdjacencyMatrix::add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0)] vertex1 and vertex2 must be different"};
+                touched.push_back(edge.vertex1);
+                touched.push_back(edge.vertex2);
             }
-
-            // check if edge already exists
-            if (!std::isnan(m_vertices.at(vertex1).second.at(vertex2)))
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            std::vector<std::pair<vertex_handle, size_t>> lists;
+            lists.reserve(touched.size());
+            for (auto vertex : touched)
             {
-                throw std::invalid_argument{"[void sgl::AdjacencyMatrix::add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0)] Edge between vertex with id " + static_cast<std::string>(vertex1) + " and vertex with id " + static_cast<std::string>(vertex2) + " already exists"};
+                lists.emplace_back(vertex, m_edges[vertex].size());
             }
 
+            // weights of existing edges to set once nothing can fail anymore
+            std::vector<std::pair<float *, float>> updates;
             try
             {
-                m_vertices.at(vertex1).second.at(vertex2) = weight;
-                m_vertices.at(vertex2).second.at(vertex1) = weight;
+                for (auto &edge : edges)
+                {
+                    m_edges[edge.vertex1].emplace_back(edge.vertex2, edge.weight);
+                    m_edges[edge.vertex2].emplace_back(edge.vertex1, edge.weight);
+                }
+
+                for (auto &[vertex, size] : lists)
+                {
+                    merge_neighbors(vertex, size, policy, updates);
+                }
+            }
+            catch (...)
+            {
+                for (auto &[vertex, size] : lists)
+                {
+                    m_edges[vertex].erase(m_edges[vertex].begin() + size, m_edges[vertex].end());
+                }
+                throw;
             }
-            catch (const std::out_of_range &e)
+
+            for (auto &[weight, new_weight] : updates)
             {
-                throw std::out_of_range{"[void sgl::AdjacencyMatrix::add_edge(const uuid &vertex1, const uuid &vertex2, const float weight = 0)] Vertex with id " + static_cast<std::string>(vertex1) + " or " + static_cast<std::string>(vertex2) + " not found"};
+                *weight = new_weight;
             }
         }
 
-        void remove_vertex(const uuid &vertex) override
+        // Sorts the neighbors from position first on, which were appended by
+        // add_edges, merges the repeated ones and removes the ones that were
+        // neighbors already, recording their new weight in updates. Neighbors
+        // before first are not modified. The sort is stable, so repeated
+        // neighbors stay in the order of the batch.
+        void merge_neighbors(vertex_handle vertex, size_t first, DuplicatePolicy policy, std::vector<std::pair<float *, float>> &updates)
         {
-            if (m_vertices.find(vertex) == m_vertices.end())
+            auto &neighbors = m_edges[vertex];
+            auto begin = neighbors.begin() + first;
+            std::stable_sort(begin, neighbors.end(), [](const std::pair<vertex_handle, float> &edge1, const std::pair<vertex_handle, float> &edge2)
+                             { return edge1.first < edge2.first; });
+
+            auto last = begin;
+            for (auto it = begin; it != neighbors.end(); ++it)
             {
-                throw std::out_of_range{"[void sgl::AdjacencyMatrix::remove_vertex(const uuid &vertex) override] Vertex with id " + static_cast<std::string>(vertex) + " not found"};
+                if (last == begin || (last - 1)->first != it->first)
+                {
+                    *last++ = *it;
+                    continue;
+                }
+
+                switch (policy)
+                {
+                case DuplicatePolicy::REJECT:
+                    throw std::invalid_argument("[void sgl::AdjacencyList::add_edges(std::vector<Edge> edges, DuplicatePolicy policy = DuplicatePolicy::REJECT)] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[it->first]->get_id()) + " appears more than once");
+                case DuplicatePolicy::KEEP_FIRST:
+                    break;
+                case DuplicatePolicy::KEEP_LAST:
+                    (last - 1)->second = it->second;
+                    break;
+                case DuplicatePolicy::KEEP_MIN:
+                    (last - 1)->second = std::min((last - 1)->second, it->second);
+                    break;
+                }
             }
+            neighbors.erase(last, neighbors.end());
 
-            m_vertices.erase(vertex);
-            for (auto &v : m_vertices)
+            // an invalid handle marks the new neighbors that already existed
+            constexpr vertex_handle existing = std::numeric_limits<vertex_handle>::max();
+            begin = neighbors.begin() + first;
+            for (auto old = neighbors.begin(); old != begin; ++old)
             {
-                v.second.second.erase(vertex);
+                auto it = std::lower_bound(begin, neighbors.end(), old->first, [](const std::pair<vertex_handle, float> &edge, vertex_handle neighbor)
+                                           { return edge.first < neighbor; });
+                if (it == neighbors.end() || it->first != old->first)
+                {
+                    continue;
+                }
+
+                switch (policy)
+                {
+                case DuplicatePolicy::REJECT:
+                    throw std::invalid_argument("[void sgl::AdjacencyList::add_edges(std::vector<Edge> edges, DuplicatePolicy policy = DuplicatePolicy::REJECT)] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[it->first]->get_id()) + " already exists");
+                case DuplicatePolicy::KEEP_FIRST:
+                    break;
+                case DuplicatePolicy::KEEP_LAST:
+                    updates.emplace_back(&old->second, it->second);
+                    break;
+                case DuplicatePolicy::KEEP_MIN:
+                    updates.emplace_back(&old->second, std::min(old->second, it->second));
+                    break;
+                }
+                it->first = existing;
             }
+            neighbors.erase(std::remove_if(begin, neighbors.end(), [](const std::pair<vertex_handle, float> &edge)
+                                           { return edge.first == existing; }),
+                            neighbors.end());
         }
 
-        void remove_edge(const uuid &vertex1, const uuid &vertex2) override
+        void remove_vertices(std::vector<vertex_handle> vertices) override
         {
-            if (vertex1 == vertex2)
+            this->prepare_vertices(vertices);
+
+            // bitmaps over the handles cost a word per 64 of them, worth it
+            // only when the batch is as large. A small batch is searched as
+            // sorted by prepare_vertices and its neighbors are sorted instead.
+            const bool dense = vertices.size() >= m_vertices.size() / 64;
+            std::vector<bool> marked;
+            std::vector<bool> visited;
+            if (dense)
             {
-                throw std::invalid_argument("[void sgl::AdjacencyMatrix::remove_edge(const uuid &vertex1, const uuid &vertex2)] vertex1 and vertex2 must be different");
+                marked.resize(m_vertices.size(), false);
+                visited.resize(m_vertices.size(), false);
+                for (auto vertex : vertices)
+                {
+                    marked[vertex] = true;
+                }
             }
+            auto removed = [&](vertex_handle vertex)
+            {
+                return dense ? static_cast<bool>(marked[vertex]) : std::binary_search(vertices.begin(), vertices.end(), vertex);
+            };
 
-            try
+            // every surviving neighbor drops all of its removed neighbors in
+            // a single pass over its list
+            std::vector<vertex_handle> neighbors;
+            for (auto vertex : vertices)
+            {
+                for (auto &neighbor : m_edges[vertex])
+                {
+                    if (!dense)
+                    {
+                        neighbors.push_back(neighbor.first);
+                    }
+                    else if (!marked[neighbor.first] && !visited[neighbor.first])
+                    {
+                        visited[neighbor.first] = true;
+                        neighbors.push_back(neighbor.first);
+                    }
+                }
+            }
+            if (!dense)
             {
-                m_vertices.at(vertex1).second.at(vertex2) = std::nanf("Not adjacent");
-                m_vertices.at(vertex2).second.at(vertex1) = std::nanf("Not adjacent");
+                std::sort(neighbors.begin(), neighbors.end());
+                neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
             }
-            catch (const std::out_of_range &e)
+            for (auto neighbor : neighbors)
+            {
+                if (!removed(neighbor))
+                {
+                    std::erase_if(m_edges[neighbor], [&removed](const std::pair<vertex_handle, float> &edge)
+                                  { return removed(edge.first); });
+                }
+            }
+
+            for (auto vertex : vertices)
             {
-                throw std::out_of_range{"[void sgl::AdjacencyMatrix::remove_edge(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex1) + " or " + static_cast<std::string>(vertex2) + " not found"};
+                m_edges[vertex].clear();
+                this->erase_vertex(vertex);
             }
         }
 
@@ -960,85 +1359,92 @@ namespace sgl
                               bool, std::invoke_result_t<FUNCTION, const VERTEX_TYPE &,
                                                          ARGS...>>)
             {
-                throw std::invalid_argument("[void sgl::AdjacencyMatrix::remove_if(FUNCTION &&function, ARGS &&...args)] return type of function must be bool");
+                throw std::invalid_argument("[void sgl::AdjacencyList::remove_if(FUNCTION &&function, ARGS &&...args)] return type of function must be bool");
             }
             else
             {
-                std::vector<uuid> to_remove;
+                std::vector<vertex_handle> to_remove;
                 for (auto it = cbegin(); it != cend(); ++it)
                 {
                     if (function(*it, std::forward<ARGS>(args)...))
                     {
-                        to_remove.push_back(it->get_id());
+                        to_remove.push_back(it->get_handle());
                     }
                 }
-                for (auto &id : to_remove)
-                {
-                    remove_vertex(id);
-                }
+                remove_vertices(std::move(to_remove));
             }
         }
 
-        const VERTEX_TYPE &vertex(const uuid &id) const override { return *m_vertices.at(id).first; }
-        VERTEX_TYPE &vertex(const uuid &id) override { return *m_vertices.at(id).first; }
-
-        const float &weight(const uuid &vertex1, const uuid &vertex2) const override
+        const float &weight(vertex_handle vertex1, vertex_handle vertex2) const override
         {
             if (vertex1 == vertex2)
             {
-                throw std::invalid_argument("[const float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2) const] vertex1 and vertex2 must be different");
+                throw std::invalid_argument("[const float& sgl::AdjacencyList::weight(vertex_handle vertex1, vertex_handle vertex2) const] vertex1 and vertex2 must be different");
             }
 
-            if (m_vertices.find(vertex1) == m_vertices.end())
+            if (!this->contains(vertex1))
             {
-                throw std::out_of_range{"[const float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2) const] Vertex with id " + static_cast<std::string>(vertex1) + " not found"};
+                throw std::out_of_range{"[const float& sgl::AdjacencyList::weight(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex1) + " not found"};
             }
 
-            if (m_vertices.find(vertex2) == m_vertices.end())
+            if (!this->contains(vertex2))
             {
-                throw std::out_of_range{"[const float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2) const] Vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+                throw std::out_of_range{"[const float& sgl::AdjacencyList::weight(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex2) + " not found"};
             }
 
-            if (std::isnan(m_vertices.at(vertex1).second.at(vertex2)))
+            for (auto &neighbor : m_edges[vertex1])
             {
-                throw std::out_of_range{"[const float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2) const] Edge between vertex with id " + static_cast<std::string>(vertex1) + " and vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+                if (neighbor.first == vertex2)
+                {
+                    return neighbor.second;
+                }
             }
 
-            return m_vertices.at(vertex1).second.at(vertex2);
+            throw std::out_of_range{"[const float& sgl::AdjacencyList::weight(vertex_handle vertex1, vertex_handle vertex2) const] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex1]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[vertex2]->get_id()) + " not found"};
         }
 
-        float &weight(const uuid &vertex1, const uuid &vertex2) override
+        float &weight(vertex_handle vertex1, vertex_handle vertex2) override
         {
-            if (vertex1 == vertex2)
-            {
-                throw std::invalid_argument("[float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2)] vertex1 and vertex2 must be different");
-            }
+            return const_cast<float &>(std::as_const(*this).weight(vertex1, vertex2));
+        }
 
-            if (m_vertices.find(vertex1) == m_vertices.end())
+        size_t size(vertex_handle vertex) const override
+        {
+            if (!this->contains(vertex))
             {
-                throw std::out_of_range{"[float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex1) + " not found"};
+                throw std::out_of_range{"[size_t sgl::AdjacencyList::size(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
             }
+            return m_edges[vertex].size();
+        }
 
-            if (m_vertices.find(vertex2) == m_vertices.end())
-            {
-                throw std::out_of_range{"[float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2)] Vertex with id " + static_cast<std::string>(vertex2) + " not found"};
-            }
+        void clear() override
+        {
+            this->clear_vertices();
+            m_edges.clear();
+        }
 
-            if (std::isnan(m_vertices.at(vertex1).second.at(vertex2)))
+        void reserve(size_t vertices, size_t edges) override
+        {
+            this->reserve_vertices(vertices);
+            m_edges.reserve(vertices);
+            m_degree_hint = vertices == 0 ? 0 : (2 * edges + vertices - 1) / vertices;
+            for (auto &neighbors : m_edges)
             {
-                throw std::out_of_range{"[float &sgl::AdjacencyMatrix::weight(const uuid &vertex1, const uuid &vertex2)] Edge between vertex with id " + static_cast<std::string>(vertex1) + " and vertex with id " + static_cast<std::string>(vertex2) + " not found"};
+                neighbors.reserve(m_degree_hint);
             }
-
-            return m_vertices.at(vertex1).second.at(vertex2);
         }
 
-        size_t size() const override { return m_vertices.size(); }
-        size_t size(const uuid &id) const override
+        void shrink_to_fit() override
         {
-            return std::count_if(m_vertices.at(id).second.begin(), m_vertices.at(id).second.end(), [](const auto &pair)
-                                 { return !std::isnan(pair.second); });
+            this->shrink_vertices();
+            m_degree_hint = 0;
+            m_edges.resize(m_vertices.size());
+            m_edges.shrink_to_fit();
+            for (auto &neighbors : m_edges)
+            {
+                neighbors.shrink_to_fit();
+            }
         }
-        void clear() override { m_vertices.clear(); }
 
         std::ostream &print(std::ostream &os = std::cout) const override
         {
@@ -1049,34 +1455,43 @@ namespace sgl
             return os;
         }
 
+        template <VisitPolicy policy = VisitPolicy::RELATED,
+                  template <typename> typename ALGORITHM, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(ALGORITHM<AdjacencyList<DATA_TYPE>> &algorithm, const uuid &id, FUNCTION function, ARGS &&...args)
+        {
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
+        }
+
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
                   typename... ARGS>
-        void traverse(const uuid &id, FUNCTION function, ARGS &&...args)
+        auto traverse(const uuid &id, FUNCTION function, ARGS &&...args)
         {
-            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
-            algorithm.template traverse<policy>(*this, id, function,
+            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
+            return algorithm.template traverse<policy>(*this, id, function,
                                                 std::forward<ARGS>(args)...);
         }
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
                   typename... ARGS>
-        void traverse(FUNCTION function, ARGS &&...args)
+        auto traverse(FUNCTION function, ARGS &&...args)
         {
-            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
-            const uuid &id = m_vertices.begin()->first;
-            algorithm.template traverse<policy>(*this, id, function,
+            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
+            const uuid id = size() == 0 ? uuid{} : cbegin()->get_id();
+            return algorithm.template traverse<policy>(*this, id, function,
                                                 std::forward<ARGS>(args)...);
         }
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED>
-        void traverse(const uuid &id)
+        auto traverse(const uuid &id)
         {
-            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
-            algorithm.template traverse<policy>(*this, id,
-                                                [](const Vertex<DATA_TYPE> &vertex)
+            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
+            return algorithm.template traverse<policy>(*this, id,
+                                                [](const VERTEX_TYPE &vertex)
                                                 {
                                                     std::cout << vertex << std::endl;
                                                 });
@@ -1084,515 +1499,2674 @@ namespace sgl
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED>
-        void traverse()
+        auto traverse()
         {
-            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
-            const uuid &id = m_vertices.begin()->first;
-            algorithm.template traverse<policy>(*this, id,
-                                                [](const Vertex<DATA_TYPE> &vertex)
+            ALGORITHM<AdjacencyList<DATA_TYPE>> algorithm;
+            const uuid id = size() == 0 ? uuid{} : cbegin()->get_id();
+            return algorithm.template traverse<policy>(*this, id,
+                                                [](const VERTEX_TYPE &vertex)
                                                 {
                                                     std::cout << vertex << std::endl;
                                                 });
         }
 
-        friend std::ostream &operator<<(std::ostream &os, const AdjacencyMatrix &matrix)
+        friend std::ostream &operator<<(std::ostream &os, const AdjacencyList &list)
         {
-            return matrix.print(os);
+            return list.print(os);
         }
 
-        base_const_iterator cbegin() const override { return base_const_iterator{std::make_shared<const_iterator<const_vertex_iterator>>(m_vertices.cbegin(), m_vertices)}; }
-        base_const_iterator cend() const override { return base_const_iterator{std::make_shared<const_iterator<const_vertex_iterator>>(m_vertices.cend(), m_vertices)}; }
-        base_iterator begin() override { return base_iterator{std::make_shared<iterator<vertex_iterator>>(m_vertices.begin(), m_vertices)}; }
-        base_iterator end() override { return base_iterator{std::make_shared<iterator<vertex_iterator>>(m_vertices.end(), m_vertices)}; }
+        const_neighbor_iterator cbegin(vertex_handle vertex) const { return const_neighbor_iterator{m_edges[vertex].cbegin(), m_vertices}; }
+        const_neighbor_iterator cend(vertex_handle vertex) const { return const_neighbor_iterator{m_edges[vertex].cend(), m_vertices}; }
+        const_neighbor_iterator begin(vertex_handle vertex) const { return cbegin(vertex); }
+        const_neighbor_iterator end(vertex_handle vertex) const { return cend(vertex); }
+        neighbor_iterator begin(vertex_handle vertex) { return neighbor_iterator{m_edges[vertex].begin(), m_vertices}; }
+        neighbor_iterator end(vertex_handle vertex) { return neighbor_iterator{m_edges[vertex].end(), m_vertices}; }
 
-        base_const_iterator cbegin(const uuid &id) const override
+    public:
+        template <bool IS_CONST>
+        class basic_neighbor_iterator
         {
-            auto it = m_vertices.at(id).second.cbegin();
-            while (it != m_vertices.at(id).second.cend() && std::isnan(it->second))
+            using storage_iterator = std::conditional_t<IS_CONST, typename edge_list::const_iterator, typename edge_list::iterator>;
+            using storage_type = const std::pmr::vector<VERTEX_TYPE *>;
+
+            friend class AdjacencyList;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = VERTEX_TYPE;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IS_CONST, const VERTEX_TYPE *, VERTEX_TYPE *>;
+            using reference = std::conditional_t<IS_CONST, const VERTEX_TYPE &, VERTEX_TYPE &>;
+
+            basic_neighbor_iterator() = default;
+
+            reference operator*() const { return *(*m_vertices)[m_it->first]; }
+            pointer operator->() const { return (*m_vertices)[m_it->first]; }
+
+            vertex_handle handle() const { return m_it->first; }
+            float weight() const { return m_it->second; }
+
+            basic_neighbor_iterator &operator++()
             {
-                ++it;
+                ++m_it;
+                return *this;
             }
-            return base_const_iterator{std::make_shared<const_iterator<const_neighbor_iterator>>(it, m_vertices)};
-        }
-        base_const_iterator cend(const uuid &id) const override { return base_const_iterator{std::make_shared<const_iterator<const_neighbor_iterator>>(m_vertices.at(id).second.cend(), m_vertices)}; }
-        base_iterator begin(const uuid &id) override
-        {
-            auto it = m_vertices.at(id).second.begin();
-            while (it != m_vertices.at(id).second.end() && std::isnan(it->second))
+            basic_neighbor_iterator operator++(int)
             {
-                ++it;
+                basic_neighbor_iterator copy = *this;
+                ++m_it;
+                return copy;
             }
-            return base_iterator{std::make_shared<iterator<neighbor_iterator>>(it, m_vertices)};
-        }
-        base_iterator end(const uuid &id) override { return base_iterator{std::make_shared<iterator<neighbor_iterator>>(m_vertices.at(id).second.end(), m_vertices)}; }
 
-        template <typename ITERATOR>
-        class iterator : public base_iterator_impl
-        {
-        public:
-            iterator(const ITERATOR &it, std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>,
-                                                                  std::map<uuid, float>>>
-                                             vertices) : m_it{it}, m_vertices{vertices} {}
-            bool operator==(const base_iterator_impl *other) const override { return m_it == static_cast<const iterator *>(other)->m_it; }
-            bool operator!=(const base_iterator_impl *other) const override { return m_it != static_cast<const iterator *>(other)->m_it; }
-            base_iterator_impl *operator++() override
+            bool operator==(const basic_neighbor_iterator &other) const { return m_it == other.m_it; }
+
+        private:
+            basic_neighbor_iterator(const storage_iterator &it, storage_type &vertices) : m_it{it}, m_vertices{&vertices} {}
+
+            storage_iterator m_it{};
+            storage_type *m_vertices = nullptr;
+        };
+    };
+
+    template <typename DATA_TYPE>
+    class AdjacencyMatrix : public DataStructureBase<DATA_TYPE, AdjacencyMatrix>
+    {
+    public:
+        ~AdjacencyMatrix() = default;
+
+        template <bool IS_CONST>
+        class basic_neighbor_iterator;
+
+        using neighbor_iterator = basic_neighbor_iterator<false>;
+        using const_neighbor_iterator = basic_neighbor_iterator<true>;
+
+    private:
+        using VERTEX_TYPE = Vertex<DATA_TYPE, AdjacencyMatrix>;
+        using BASE_TYPE = DataStructureBase<DATA_TYPE, AdjacencyMatrix>;
+
+        using word_type = std::uint64_t;
+        static constexpr size_t word_bits = 64;
+
+        friend class BFS<AdjacencyMatrix<DATA_TYPE>>;
+        friend class DFS<AdjacencyMatrix<DATA_TYPE>>;
+        friend class ParallelBFS<AdjacencyMatrix<DATA_TYPE>>;
+        friend class Graph<DATA_TYPE, AdjacencyMatrix>;
+        friend class Vertex<DATA_TYPE, AdjacencyMatrix>;
+        friend class VertexPrinter;
+
+        using BASE_TYPE::add_edge;
+        using BASE_TYPE::begin;
+        using BASE_TYPE::cbegin;
+        using BASE_TYPE::cend;
+        using BASE_TYPE::end;
+        using BASE_TYPE::handle_bound;
+        using BASE_TYPE::remove_edge;
+        using BASE_TYPE::remove_vertex;
+        using BASE_TYPE::size;
+        using BASE_TYPE::weight;
+
+        using BASE_TYPE::m_vertices;
+
+        // Both matrices are row-major with m_capacity rows, a multiple of
+        // word_bits that doubles when add_vertex outgrows it and is set exactly
+        // by reserve and shrink_to_fit. Bit vertex2 of
+        // row vertex1 of m_adjacency is set if the two handles are adjacent,
+        // m_weights[vertex1 * m_capacity + vertex2] is the weight of their edge,
+        // NaN if they are not adjacent.
+        size_t m_capacity = 0;
+        std::pmr::vector<float> m_weights;
+        std::pmr::vector<word_type> m_adjacency;
+
+        explicit AdjacencyMatrix(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : BASE_TYPE{resource}, m_weights{this->m_resource}, m_adjacency{this->m_resource} {}
+
+        const uuid &add_vertex(VERTEX_TYPE &&vertex) override
+        {
+            // grow first so a failed allocation leaves the matrix untouched, a
+            // reused handle has an empty row and column already
+            if (this->m_free_handles.empty())
             {
-                if constexpr (std::is_same_v<ITERATOR, vertex_iterator>)
-                {
-                    ++m_it;
-                    return this;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, neighbor_iterator>)
-                {
-                    ++m_it;
-                    while (std::isnan(m_it->second))
-                    {
-                        ++m_it;
-                    }
-                    return this;
-                }
+                reserve_handles(m_vertices.size() + 1);
             }
-            base_iterator_impl *operator--() override
+
+            VERTEX_TYPE &new_vertex = this->insert_vertex(std::forward<VERTEX_TYPE>(vertex));
+            new_vertex.add_data_structure(this);
+            return new_vertex.get_id();
+        }
+
+        const uuid &add_vertex(DATA_TYPE &&data) override
+        {
+            VERTEX_TYPE vertex{std::forward<DATA_TYPE>(data)};
+            return add_vertex(std::move(vertex));
+        }
+
+        void add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0) override
+        {
+            if (vertex1 == vertex2)
             {
-                if constexpr (std::is_same_v<ITERATOR, vertex_iterator>)
-                {
-                    --m_it;
-                    return this;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, neighbor_iterator>)
-                {
-                    --m_it;
-                    while (std::isnan(m_it->second))
-                    {
-                        --m_it;
-                    }
-                    return this;
-                }
+                throw std::invalid_argument{"[void sgl::AdjacencyMatrix::add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)] vertex1 and vertex2 must be different"};
             }
-            VERTEX_TYPE &operator*() const override
+
+            if (!this->contains(vertex1) || !this->contains(vertex2))
             {
-                if constexpr (std::is_same_v<ITERATOR, vertex_iterator>)
-                {
-                    return *m_it->second.first;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, neighbor_iterator>)
-                {
-                    return *m_vertices.at(m_it->first).first;
-                }
+                throw std::out_of_range{"[void sgl::AdjacencyMatrix::add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)] Vertex with handle " + std::to_string(vertex1) + " or " + std::to_string(vertex2) + " not found"};
             }
-            VERTEX_TYPE *operator->() const override
+
+            // check if edge already exists
+            if (adjacent(vertex1, vertex2))
             {
-                if constexpr (std::is_same_v<ITERATOR, vertex_iterator>)
-                {
-                    return m_it->second.first.get();
-                }
-                else if constexpr (std::is_same_v<ITERATOR, neighbor_iterator>)
-                {
-                    return m_vertices.at(m_it->first).first.get();
-                }
+                throw std::invalid_argument{"[void sgl::AdjacencyMatrix::add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex1]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[vertex2]->get_id()) + " already exists"};
             }
 
-        private:
-            ITERATOR m_it;
-            std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>,
-                                     std::map<uuid, float>>>
-                m_vertices;
-        };
+            set_edge(vertex1, vertex2, weight);
+            set_edge(vertex2, vertex1, weight);
+        }
 
-        template <typename ITERATOR>
-        class const_iterator : public base_const_iterator_impl
+        void remove_vertex(vertex_handle vertex) override
         {
-        public:
-            const_iterator(const ITERATOR &it, std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>,
-                                                                        std::map<uuid, float>>>
-                                                   vertices) : m_it{it}, m_vertices{vertices} {}
-            bool operator==(const base_const_iterator_impl *other) const override { return m_it == static_cast<const const_iterator *>(other)->m_it; }
-            bool operator!=(const base_const_iterator_impl *other) const override { return m_it != static_cast<const const_iterator *>(other)->m_it; }
-            base_const_iterator_impl *operator++() override
+            if (!this->contains(vertex))
             {
-                if constexpr (std::is_same_v<ITERATOR, const_vertex_iterator>)
-                {
-                    ++m_it;
-                    return this;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, const_neighbor_iterator>)
-                {
-                    ++m_it;
-                    while (std::isnan(m_it->second))
-                    {
-                        ++m_it;
-                    }
-                    return this;
-                }
+                throw std::out_of_range{"[void sgl::AdjacencyMatrix::remove_vertex(vertex_handle vertex)] Vertex with handle " + std::to_string(vertex) + " not found"};
             }
-            base_const_iterator_impl *operator--() override
+
+            for (auto it = cbegin(vertex); it != cend(vertex); ++it)
             {
-                if constexpr (std::is_same_v<ITERATOR, const_vertex_iterator>)
-                {
-                    --m_it;
-                    return this;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, const_neighbor_iterator>)
+                reset_edge(it.handle(), vertex);
+            }
+            std::fill_n(adjacency_row(vertex), m_capacity / word_bits, word_type{0});
+            std::fill_n(m_weights.begin() + vertex * m_capacity, m_capacity, std::nanf("Not adjacent"));
+            this->erase_vertex(vertex);
+        }
+
+        void remove_edge(vertex_handle vertex1, vertex_handle vertex2) override
+        {
+            if (vertex1 == vertex2)
+            {
+                throw std::invalid_argument("[void sgl::AdjacencyMatrix::remove_edge(vertex_handle vertex1, vertex_handle vertex2)] vertex1 and vertex2 must be different");
+            }
+
+            if (!this->contains(vertex1) || !this->contains(vertex2))
+            {
+                throw std::out_of_range{"[void sgl::AdjacencyMatrix::remove_edge(vertex_handle vertex1, vertex_handle vertex2)] Vertex with handle " + std::to_string(vertex1) + " or " + std::to_string(vertex2) + " not found"};
+            }
+
+            reset_edge(vertex1, vertex2);
+            reset_edge(vertex2, vertex1);
+        }
+
+        // The edges are set one after the other, so a repeated edge is
+        // treated like one that already existed. Nothing allocates, only a
+        // rejected edge has to undo the ones before it, which were all new.
+        void add_edges(std::vector<Edge> edges, DuplicatePolicy policy = DuplicatePolicy::REJECT) override
+        {
+            this->check_edges(edges);
+
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                const Edge &edge = edges[i];
+                float weight = edge.weight;
+                if (adjacent(edge.vertex1, edge.vertex2))
                 {
-                    --m_it;
-                    while (std::isnan(m_it->second))
+                    const float current = m_weights[edge.vertex1 * m_capacity + edge.vertex2];
+                    switch (policy)
                     {
-                        --m_it;
+                    case DuplicatePolicy::REJECT:
+                        for (size_t j = 0; j < i; ++j)
+                        {
+                            reset_edge(edges[j].vertex1, edges[j].vertex2);
+                            reset_edge(edges[j].vertex2, edges[j].vertex1);
+                        }
+                        throw std::invalid_argument{"[void sgl::AdjacencyMatrix::add_edges(std::vector<Edge> edges, DuplicatePolicy policy = DuplicatePolicy::REJECT)] Edge between vertex with id " + static_cast<std::string>(m_vertices[edge.vertex1]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[edge.vertex2]->get_id()) + " already exists"};
+                    case DuplicatePolicy::KEEP_FIRST:
+                        weight = current;
+                        break;
+                    case DuplicatePolicy::KEEP_LAST:
+                        break;
+                    case DuplicatePolicy::KEEP_MIN:
+                        weight = std::min(current, weight);
+                        break;
                     }
-                    return this;
                 }
+                set_edge(edge.vertex1, edge.vertex2, weight);
+                set_edge(edge.vertex2, edge.vertex1, weight);
             }
-            const VERTEX_TYPE &operator*() const override
+        }
+
+        // the handles are checked and m_free_handles has room for them after
+        // prepare_vertices, so none of the removals can throw
+        void remove_vertices(std::vector<vertex_handle> vertices) override
+        {
+            this->prepare_vertices(vertices);
+            for (auto vertex : vertices)
             {
-                if constexpr (std::is_same_v<ITERATOR, const_vertex_iterator>)
-                {
-                    return *m_it->second.first;
-                }
-                else if constexpr (std::is_same_v<ITERATOR, const_neighbor_iterator>)
-                {
-                    return *m_vertices.at(m_it->first).first;
-                }
+                remove_vertex(vertex);
             }
-            const VERTEX_TYPE *operator->() const override
+        }
+
+        template <typename FUNCTION, typename... ARGS>
+        void remove_if(FUNCTION &&function, ARGS &&...args)
+        {
+            if constexpr (!std::is_same_v<
+                              bool, std::invoke_result_t<FUNCTION, const VERTEX_TYPE &,
+                                                         ARGS...>>)
             {
-                if constexpr (std::is_same_v<ITERATOR, const_vertex_iterator>)
-                {
-                    return m_it->second.first.get();
-                }
-                else if constexpr (std::is_same_v<ITERATOR, const_neighbor_iterator>)
+                throw std::invalid_argument("[void sgl::AdjacencyMatrix::remove_if(FUNCTION &&function, ARGS &&...args)] return type of function must be bool");
+            }
+            else
+            {
+                std::vector<vertex_handle> to_remove;
+                for (auto it = cbegin(); it != cend(); ++it)
                 {
-                    return m_vertices.at(m_it->first).first.get();
+                    if (function(*it, std::forward<ARGS>(args)...))
+                    {
+                        to_remove.push_back(it->get_handle());
+                    }
                 }
+                remove_vertices(std::move(to_remove));
             }
+        }
 
-        private:
-            ITERATOR m_it;
-            std::map<uuid, std::pair<std::shared_ptr<VERTEX_TYPE>,
-                                     std::map<uuid, float>>>
-                m_vertices;
-        };
-    };
+        const float &weight(vertex_handle vertex1, vertex_handle vertex2) const override
+        {
+            if (vertex1 == vertex2)
+            {
+                throw std::invalid_argument("[const float& sgl::AdjacencyMatrix::weight(vertex_handle vertex1, vertex_handle vertex2) const] vertex1 and vertex2 must be different");
+            }
 
-    template <typename DATA_TYPE,
-              template <typename> typename DATA_STRUCTURE = AdjacencyList>
-    class Graph
-    {
-    public:
-        using VERTEX_TYPE = Vertex<DATA_TYPE>;
+            if (!this->contains(vertex1))
+            {
+                throw std::out_of_range{"[const float& sgl::AdjacencyMatrix::weight(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex1) + " not found"};
+            }
 
-        using base_const_iterator =
-            typename DATA_STRUCTURE<DATA_TYPE>::base_const_iterator;
+            if (!this->contains(vertex2))
+            {
+                throw std::out_of_range{"[const float& sgl::AdjacencyMatrix::weight(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex2) + " not found"};
+            }
 
-        using base_iterator = typename DATA_STRUCTURE<DATA_TYPE>::base_iterator;
+            if (!adjacent(vertex1, vertex2))
+            {
+                throw std::out_of_range{"[const float& sgl::AdjacencyMatrix::weight(vertex_handle vertex1, vertex_handle vertex2) const] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex1]->get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[vertex2]->get_id()) + " not found"};
+            }
 
-        friend class VertexPrinter;
+            return m_weights[vertex1 * m_capacity + vertex2];
+        }
 
-        Graph()
+        float &weight(vertex_handle vertex1, vertex_handle vertex2) override
         {
-            DATA_STRUCTURE<DATA_TYPE> data_structure;
-            m_data_structure = std::make_shared<DATA_STRUCTURE<DATA_TYPE>>(data_structure);
+            return const_cast<float &>(std::as_const(*this).weight(vertex1, vertex2));
         }
-        ~Graph() = default;
 
-        const uuid &add_vertex(VERTEX_TYPE &&vertex)
+        // writes the weight of the edge between vertex and each handle of
+        // [first, last) to out, NaN where they are not adjacent
+        template <typename INPUT_ITERATOR, typename OUTPUT_ITERATOR>
+        OUTPUT_ITERATOR weights(vertex_handle vertex, INPUT_ITERATOR first, INPUT_ITERATOR last, OUTPUT_ITERATOR out) const
         {
-            return m_data_structure->add_vertex(std::forward<VERTEX_TYPE>(vertex));
+            if (!this->contains(vertex))
+            {
+                throw std::out_of_range{"[OUTPUT_ITERATOR sgl::AdjacencyMatrix::weights(vertex_handle vertex, INPUT_ITERATOR first, INPUT_ITERATOR last, OUTPUT_ITERATOR out) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+            }
+
+            // rows are m_capacity long and NaN past handle_bound()
+            const float *row = m_weights.data() + vertex * m_capacity;
+            for (; first != last; ++first, ++out)
+            {
+                *out = static_cast<size_t>(*first) < m_capacity ? row[*first] : std::nanf("Not adjacent");
+            }
+            return out;
         }
-        const uuid &add_vertex(VERTEX_TYPE &vertex)
+
+        size_t size(vertex_handle vertex) const override
         {
-            DATA_TYPE copy = vertex.data();
-            return m_data_structure->add_vertex(std::move(copy));
+            if (!this->contains(vertex))
+            {
+                throw std::out_of_range{"[size_t sgl::AdjacencyMatrix::size(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+            }
+
+            const word_type *row = adjacency_row(vertex);
+            size_t degree = 0;
+            for (size_t word = 0; word < used_words(); ++word)
+            {
+                degree += std::popcount(row[word]);
+            }
+            return degree;
         }
-        const uuid &add_vertex(DATA_TYPE &&data)
+
+        // number of vertices adjacent to both vertex1 and vertex2
+        size_t common_neighbors(vertex_handle vertex1, vertex_handle vertex2) const
         {
-            return m_data_structure->add_vertex(std::forward<DATA_TYPE>(data));
+            if (!this->contains(vertex1) || !this->contains(vertex2))
+            {
+                throw std::out_of_range{"[size_t sgl::AdjacencyMatrix::common_neighbors(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex1) + " or " + std::to_string(vertex2) + " not found"};
+            }
+            return intersection_size(adjacency_row(vertex1), adjacency_row(vertex2), 0);
         }
-        const uuid &add_vertex(DATA_TYPE &data)
+
+        // number of triangles the vertex is part of
+        size_t triangles(vertex_handle vertex) const
         {
-            DATA_TYPE copy = data;
-            return m_data_structure->add_vertex(std::move(copy));
+            if (!this->contains(vertex))
+            {
+                throw std::out_of_range{"[size_t sgl::AdjacencyMatrix::triangles(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+            }
+
+            size_t count = 0;
+            for (auto it = cbegin(vertex); it != cend(vertex); ++it)
+            {
+                count += intersection_size(adjacency_row(vertex), adjacency_row(it.handle()), 0);
+            }
+            return count / 2;
         }
-        void add_edge(const uuid &vertex1_id, const uuid &vertex2_id, const float weight = 0)
+
+        // number of triangles in the graph, every triangle u < v < w is counted
+        // once from its edge (u, v) by intersecting the rows above v
+        size_t triangles() const
         {
-            m_data_structure->add_edge(vertex1_id, vertex2_id, weight);
+            size_t count = 0;
+            for (auto &vertex : *this)
+            {
+                vertex_handle u = vertex.get_handle();
+                for (auto it = cbegin(u); it != cend(u); ++it)
+                {
+                    vertex_handle v = it.handle();
+                    if (v <= u)
+                    {
+                        continue;
+                    }
+
+                    size_t word = v / word_bits;
+                    size_t bit = v % word_bits;
+                    word_type mask = bit + 1 == word_bits ? 0 : ~word_type{0} << (bit + 1);
+                    count += std::popcount(adjacency_row(u)[word] & adjacency_row(v)[word] & mask);
+                    count += intersection_size(adjacency_row(u), adjacency_row(v), word + 1);
+                }
+            }
+            return count;
         }
-        void remove_edge(const uuid &vertex1_id, const uuid &vertex2_id)
+
+        void clear() override
         {
-            m_data_structure->remove_edge(vertex1_id, vertex2_id);
+            this->clear_vertices();
+            m_capacity = 0;
+            m_weights.clear();
+            m_adjacency.clear();
         }
-        void remove_vertex(const uuid &vertex_id)
+
+        // the matrix has no per edge storage, edges is ignored
+        void reserve(size_t vertices, size_t) override
         {
-            m_data_structure->remove_vertex(vertex_id);
+            this->reserve_vertices(vertices);
+            if (vertices > m_capacity)
+            {
+                reallocate(round_capacity(vertices));
+            }
         }
 
-        template <typename FUNCTION, typename... ARGS>
-        void remove_if(FUNCTION function, ARGS &&...args)
+        void shrink_to_fit() override
         {
-            m_data_structure->remove_if(function, std::forward<ARGS>(args)...);
+            this->shrink_vertices();
+
+            const size_t capacity = round_capacity(m_vertices.size());
+            if (capacity < m_capacity)
+            {
+                reallocate(capacity);
+            }
         }
 
-        const VERTEX_TYPE &vertex(const uuid &id) const { return m_data_structure->vertex(id); }
-        VERTEX_TYPE &vertex(const uuid &id) { return m_data_structure->vertex(id); }
-        const VERTEX_TYPE &operator()(const uuid &id) const { return m_data_structure->vertex(id); }
-        VERTEX_TYPE &operator()(const uuid &id) { return m_data_structure->vertex(id); }
-        const float &get_weight(const uuid &vertex1, const uuid &vertex2) const { return m_data_structure->weight(vertex1, vertex2); }
-        void set_weight(const uuid &vertex1, const uuid &vertex2, const float weight)
+        std::ostream &print(std::ostream &os = std::cout) const override
         {
-            m_data_structure->weight(vertex1, vertex2) = weight;
-            m_data_structure->weight(vertex2, vertex1) = weight;
+            for (auto it = cbegin(); it != cend(); ++it)
+            {
+                os << *it << std::endl;
+            }
+            return os;
         }
 
-        size_t size() const { return m_data_structure->size(); }
-        size_t size(const uuid &id) const { return m_data_structure->size(id); }
-        void clear() { m_data_structure->clear(); }
-
-        std::ostream &print(std::ostream &os = std::cout) const
+        template <VisitPolicy policy = VisitPolicy::RELATED,
+                  template <typename> typename ALGORITHM, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(ALGORITHM<AdjacencyMatrix<DATA_TYPE>> &algorithm, const uuid &id, FUNCTION function, ARGS &&...args)
         {
-            return m_data_structure->print(os);
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
         }
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
                   typename... ARGS>
-        void traverse(const uuid &id, FUNCTION function, ARGS &&...args)
+        auto traverse(const uuid &id, FUNCTION function, ARGS &&...args)
         {
-            m_data_structure->template traverse<ALGORITHM, policy>(
-                function, id, std::forward<ARGS>(args)...);
+            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
         }
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
                   typename... ARGS>
-        void traverse(FUNCTION function, ARGS &&...args)
+        auto traverse(FUNCTION function, ARGS &&...args)
         {
-            m_data_structure->template traverse<ALGORITHM, policy>(
-                function, std::forward<ARGS>(args)...);
+            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
+            const uuid id = size() == 0 ? uuid{} : cbegin()->get_id();
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
         }
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED>
-        void traverse(const uuid &id)
+        auto traverse(const uuid &id)
         {
-            m_data_structure->template traverse<ALGORITHM, policy>(id);
+            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
+            return algorithm.template traverse<policy>(*this, id,
+                                                [](const VERTEX_TYPE &vertex)
+                                                {
+                                                    std::cout << vertex << std::endl;
+                                                });
         }
 
         template <template <typename> typename ALGORITHM = BFS,
                   VisitPolicy policy = VisitPolicy::RELATED>
-        void traverse()
+        auto traverse()
         {
-            m_data_structure->template traverse<ALGORITHM, policy>();
+            ALGORITHM<AdjacencyMatrix<DATA_TYPE>> algorithm;
+            const uuid id = size() == 0 ? uuid{} : cbegin()->get_id();
+            return algorithm.template traverse<policy>(*this, id,
+                                                [](const VERTEX_TYPE &vertex)
+                                                {
+                                                    std::cout << vertex << std::endl;
+                                                });
         }
 
-        friend std::ostream &operator<<(std::ostream &os, const Graph &graph)
+        friend std::ostream &operator<<(std::ostream &os, const AdjacencyMatrix &matrix)
         {
-            return os << *graph.m_data_structure;
+            return matrix.print(os);
         }
 
-    private:
-        std::shared_ptr<DATA_STRUCTURE<DATA_TYPE>> m_data_structure;
+        const_neighbor_iterator cbegin(vertex_handle vertex) const { return const_neighbor_iterator{adjacency_row(vertex), 0, used_words(), m_weights.data() + vertex * m_capacity, m_vertices}; }
+        const_neighbor_iterator cend(vertex_handle vertex) const { return const_neighbor_iterator{adjacency_row(vertex), used_words(), used_words(), m_weights.data() + vertex * m_capacity, m_vertices}; }
+        const_neighbor_iterator begin(vertex_handle vertex) const { return cbegin(vertex); }
+        const_neighbor_iterator end(vertex_handle vertex) const { return cend(vertex); }
+        neighbor_iterator begin(vertex_handle vertex) { return neighbor_iterator{adjacency_row(vertex), 0, used_words(), m_weights.data() + vertex * m_capacity, m_vertices}; }
+        neighbor_iterator end(vertex_handle vertex) { return neighbor_iterator{adjacency_row(vertex), used_words(), used_words(), m_weights.data() + vertex * m_capacity, m_vertices}; }
 
-    public:
-        base_const_iterator begin() const { return m_data_structure->cbegin(); }
-        base_const_iterator end() const { return m_data_structure->cend(); }
-        base_iterator begin() { return m_data_structure->begin(); }
-        base_iterator end() { return m_data_structure->end(); }
-
-        base_const_iterator begin(const uuid &id) const { return m_data_structure->cbegin(id); }
-        base_const_iterator end(const uuid &id) const { return m_data_structure->cend(id); }
-        base_iterator begin(const uuid &id) { return m_data_structure->begin(id); }
-        base_iterator end(const uuid &id) { return m_data_structure->end(id); }
-    };
+        const word_type *adjacency_row(vertex_handle vertex) const { return m_adjacency.data() + vertex * (m_capacity / word_bits); }
+        word_type *adjacency_row(vertex_handle vertex) { return m_adjacency.data() + vertex * (m_capacity / word_bits); }
 
-    template <typename DATA_STRUCTURE>
-    class BFS
-    {
-        using VERTEX_TYPE = typename DATA_STRUCTURE::VERTEX_TYPE;
+        // words of a row that can have bits set
+        size_t used_words() const { return (handle_bound() + word_bits - 1) / word_bits; }
 
-    public:
-        BFS() = default;
-        ~BFS() = default;
+        bool adjacent(vertex_handle vertex1, vertex_handle vertex2) const
+        {
+            return (adjacency_row(vertex1)[vertex2 / word_bits] >> (vertex2 % word_bits)) & 1;
+        }
 
-        template <VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
-                  typename... ARGS>
-        void traverse(DATA_STRUCTURE &data_structure, const uuid &id,
-                      FUNCTION &&function, ARGS &&...args)
+        void set_edge(vertex_handle vertex1, vertex_handle vertex2, float weight)
         {
-            if (data_structure.size() == 0)
-            {
-                throw std::out_of_range{"[void sgl::BFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Graph is empty"};
-            }
+            adjacency_row(vertex1)[vertex2 / word_bits] |= word_type{1} << (vertex2 % word_bits);
+            m_weights[vertex1 * m_capacity + vertex2] = weight;
+        }
 
-            std::queue<uuid> queue;
-            std::set<uuid> visited;
+        void reset_edge(vertex_handle vertex1, vertex_handle vertex2)
+        {
+            adjacency_row(vertex1)[vertex2 / word_bits] &= ~(word_type{1} << (vertex2 % word_bits));
+            m_weights[vertex1 * m_capacity + vertex2] = std::nanf("Not adjacent");
+        }
 
-            try
+        // popcount of row1 & row2 from the given word on, a plain loop over
+        // whole words that the compiler vectorizes
+        size_t intersection_size(const word_type *row1, const word_type *row2, size_t first_word) const
+        {
+            size_t count = 0;
+            for (size_t word = first_word; word < used_words(); ++word)
+            {
+                count += std::popcount(row1[word] & row2[word]);
+            }
+            return count;
+        }
+
+        // grows both matrices geometrically so that count handles fit
+        void reserve_handles(size_t count)
+        {
+            if (count <= m_capacity)
+            {
+                return;
+            }
+
+            size_t capacity = std::max(m_capacity * 2, word_bits);
+            while (capacity < count)
+            {
+                capacity *= 2;
+            }
+            reallocate(capacity);
+        }
+
+        // the smallest capacity that holds count handles
+        static size_t round_capacity(size_t count) { return (count + word_bits - 1) / word_bits * word_bits; }
+
+        // copies the matrices into ones with the given capacity, which must
+        // still hold every handle in use
+        void reallocate(size_t capacity)
+        {
+            const size_t common = std::min(capacity, m_capacity);
+            std::pmr::vector<float> weights(capacity * capacity, std::nanf("Not adjacent"), this->m_resource);
+            std::pmr::vector<word_type> adjacency(capacity * (capacity / word_bits), 0, this->m_resource);
+            for (size_t row = 0; row < common; ++row)
+            {
+                std::copy_n(m_weights.begin() + row * m_capacity, common, weights.begin() + row * capacity);
+                std::copy_n(m_adjacency.begin() + row * (m_capacity / word_bits), common / word_bits, adjacency.begin() + row * (capacity / word_bits));
+            }
+
+            m_weights = std::move(weights);
+            m_adjacency = std::move(adjacency);
+            m_capacity = capacity;
+        }
+
+    public:
+        // Walks the set bits of an adjacency row a word at a time, the next
+        // neighbor is found with countr_zero and cleared from the current word.
+        template <bool IS_CONST>
+        class basic_neighbor_iterator
+        {
+            using weight_pointer = std::conditional_t<IS_CONST, const float *, float *>;
+            using storage_type = const std::pmr::vector<VERTEX_TYPE *>;
+
+            friend class AdjacencyMatrix;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = VERTEX_TYPE;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IS_CONST, const VERTEX_TYPE *, VERTEX_TYPE *>;
+            using reference = std::conditional_t<IS_CONST, const VERTEX_TYPE &, VERTEX_TYPE &>;
+
+            basic_neighbor_iterator() = default;
+
+            reference operator*() const { return *(*m_vertices)[handle()]; }
+            pointer operator->() const { return (*m_vertices)[handle()]; }
+
+            vertex_handle handle() const { return static_cast<vertex_handle>(m_word * word_bits + std::countr_zero(m_bits)); }
+            float weight() const { return m_row[handle()]; }
+
+            basic_neighbor_iterator &operator++()
+            {
+                m_bits &= m_bits - 1;
+                skip_empty_words();
+                return *this;
+            }
+            basic_neighbor_iterator operator++(int)
+            {
+                basic_neighbor_iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(const basic_neighbor_iterator &other) const { return m_word == other.m_word && m_bits == other.m_bits && m_adjacency == other.m_adjacency; }
+
+        private:
+            basic_neighbor_iterator(const word_type *adjacency, size_t word, size_t words, weight_pointer row, storage_type &vertices)
+                : m_adjacency{adjacency}, m_word{word}, m_words{words}, m_bits{word < words ? adjacency[word] : 0}, m_row{row}, m_vertices{&vertices}
+            {
+                skip_empty_words();
+            }
+
+            void skip_empty_words()
+            {
+                while (m_bits == 0 && m_word < m_words)
+                {
+                    ++m_word;
+                    m_bits = m_word < m_words ? m_adjacency[m_word] : 0;
+                }
+            }
+
+            const word_type *m_adjacency = nullptr;
+            size_t m_word = 0;
+            size_t m_words = 0;
+            word_type m_bits = 0;
+            weight_pointer m_row = nullptr;
+            storage_type *m_vertices = nullptr;
+        };
+    };
+
+    // Immutable compressed sparse row snapshot of a graph, built by converting
+    // another graph (Graph::freeze) and turned back into a mutable one with
+    // Graph::thaw. Only vertex data and edge weights can be changed, so it does
+    // not implement the mutating DataStructureBase interface.
+    template <typename DATA_TYPE>
+    class CSRGraph
+    {
+    public:
+        ~CSRGraph() = default;
+
+        template <bool IS_CONST>
+        class basic_neighbor_iterator;
+
+        using iterator = typename std::pmr::vector<Vertex<DATA_TYPE, CSRGraph>>::iterator;
+        using const_iterator = typename std::pmr::vector<Vertex<DATA_TYPE, CSRGraph>>::const_iterator;
+        using neighbor_iterator = basic_neighbor_iterator<false>;
+        using const_neighbor_iterator = basic_neighbor_iterator<true>;
+
+    private:
+        using VERTEX_TYPE = Vertex<DATA_TYPE, CSRGraph>;
+
+        friend class BFS<CSRGraph<DATA_TYPE>>;
+        friend class DFS<CSRGraph<DATA_TYPE>>;
+        friend class ParallelBFS<CSRGraph<DATA_TYPE>>;
+        friend class Graph<DATA_TYPE, CSRGraph>;
+        friend class Vertex<DATA_TYPE, CSRGraph>;
+        friend class VertexPrinter;
+
+        // the handle of a vertex is its index in m_vertices, its neighbors are
+        // m_targets[m_offsets[handle]] .. m_targets[m_offsets[handle + 1] - 1]
+        // sorted by handle, with the weights of the edges at the same positions
+        // of m_weights. The three spans refer to the storage vectors below or,
+        // for a graph opened with io::MappedGraph::csr, into the file.
+#if SGL_INSTRUMENT
+        mutable Stats m_stats;
+        Stats::counting_resource m_counting_resource;
+#endif
+        std::pmr::memory_resource *m_resource;
+        std::pmr::vector<VERTEX_TYPE> m_vertices;
+        std::pmr::vector<std::uint64_t> m_offset_storage;
+        std::pmr::vector<vertex_handle> m_target_storage;
+        std::pmr::vector<float> m_weight_storage;
+        std::span<const std::uint64_t> m_offsets;
+        std::span<const vertex_handle> m_targets;
+        std::span<float> m_weights;
+        std::pmr::unordered_map<uuid, vertex_handle, uuid::hash> m_index;
+
+        explicit CSRGraph(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+#if SGL_INSTRUMENT
+            : m_counting_resource{resource, m_stats}, m_resource{&m_counting_resource},
+#else
+            : m_resource{resource},
+#endif
+              m_vertices{m_resource}, m_offset_storage(1, 0, m_resource), m_target_storage{m_resource}, m_weight_storage{m_resource}, m_index{m_resource}
+        {
+            use_storage();
+        }
+        CSRGraph(const CSRGraph &other) = delete;
+        CSRGraph &operator=(const CSRGraph &other) = delete;
+
+        template <typename OTHER_GRAPH>
+        void assign(const OTHER_GRAPH &other)
+        {
+            clear();
+
+            std::vector<vertex_handle> handles(other.handle_bound());
+            m_vertices.reserve(other.size());
+            m_offset_storage.reserve(other.size() + 1);
+            m_index.reserve(other.size());
+
+            for (auto &vertex : other)
+            {
+                vertex_handle handle = static_cast<vertex_handle>(m_vertices.size());
+                handles[vertex.get_handle()] = handle;
+
+                m_vertices.emplace_back(DATA_TYPE(vertex.data()), this);
+                m_vertices.back().m_uuid = vertex.get_id();
+                m_vertices.back().m_handle = handle;
+                m_index.emplace(vertex.get_id(), handle);
+                m_offset_storage.push_back(m_offset_storage.back() + vertex.size());
+            }
+
+            m_target_storage.resize(m_offset_storage.back());
+            m_weight_storage.resize(m_offset_storage.back());
+            use_storage();
+
+            std::vector<std::pair<vertex_handle, float>> row;
+            for (auto &vertex : other)
+            {
+                row.clear();
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                {
+                    row.emplace_back(handles[it.handle()], it.weight());
+                }
+                std::sort(row.begin(), row.end());
+
+                size_t offset = m_offset_storage[handles[vertex.get_handle()]];
+                for (size_t i = 0; i < row.size(); ++i)
+                {
+                    m_target_storage[offset + i] = row[i].first;
+                    m_weight_storage[offset + i] = row[i].second;
+                }
+            }
+        }
+
+        // Copies the vertices of a file checked by io::MappedGraph, the edges
+        // are used in place. The handles are the positions in the file.
+        void assign(const io::MappedGraph<DATA_TYPE> &file)
+        {
+            clear();
+
+            m_vertices.reserve(file.size());
+            m_index.reserve(file.size());
+            for (vertex_handle vertex = 0; vertex < file.size(); ++vertex)
+            {
+                m_vertices.emplace_back(DATA_TYPE(file.data(vertex)), this);
+                m_vertices.back().m_uuid = file.id(vertex);
+                m_vertices.back().m_handle = vertex;
+                m_index.emplace(file.id(vertex), vertex);
+            }
+
+            m_offsets = file.offsets();
+            m_targets = file.template section<vertex_handle>(file.m_header->targets, file.m_header->entries);
+            m_weights = file.weight_section();
+        }
+
+        void use_storage()
+        {
+            m_offsets = m_offset_storage;
+            m_targets = m_target_storage;
+            m_weights = m_weight_storage;
+        }
+
+        vertex_handle handle(const uuid &id) const
+        {
+            SGL_COUNT(m_stats, lookups, 1);
+            auto it = m_index.find(id);
+            if (it == m_index.end())
+            {
+                throw std::out_of_range{"[vertex_handle sgl::CSRGraph::handle(const uuid &id) const] Vertex with id " + static_cast<std::string>(id) + " not found"};
+            }
+            return it->second;
+        }
+
+        bool contains(vertex_handle handle) const { return handle < m_vertices.size(); }
+
+        const VERTEX_TYPE &vertex(const uuid &id) const { return m_vertices[handle(id)]; }
+        VERTEX_TYPE &vertex(const uuid &id) { return m_vertices[handle(id)]; }
+        const VERTEX_TYPE &vertex(vertex_handle handle) const
+        {
+            if (!contains(handle))
+            {
+                throw std::out_of_range{"[const VERTEX_TYPE &sgl::CSRGraph::vertex(vertex_handle handle) const] Vertex with handle " + std::to_string(handle) + " not found"};
+            }
+            return m_vertices[handle];
+        }
+        VERTEX_TYPE &vertex(vertex_handle handle)
+        {
+            if (!contains(handle))
+            {
+                throw std::out_of_range{"[VERTEX_TYPE &sgl::CSRGraph::vertex(vertex_handle handle)] Vertex with handle " + std::to_string(handle) + " not found"};
+            }
+            return m_vertices[handle];
+        }
+
+        const float &weight(vertex_handle vertex1, vertex_handle vertex2) const
+        {
+            if (vertex1 == vertex2)
+            {
+                throw std::invalid_argument("[const float& sgl::CSRGraph::weight(vertex_handle vertex1, vertex_handle vertex2) const] vertex1 and vertex2 must be different");
+            }
+
+            if (!contains(vertex1) || !contains(vertex2))
+            {
+                throw std::out_of_range{"[const float& sgl::CSRGraph::weight(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex1) + " or " + std::to_string(vertex2) + " not found"};
+            }
+
+            auto first = m_targets.begin() + m_offsets[vertex1];
+            auto last = m_targets.begin() + m_offsets[vertex1 + 1];
+            auto it = std::lower_bound(first, last, vertex2);
+            if (it == last || *it != vertex2)
+            {
+                throw std::out_of_range{"[const float& sgl::CSRGraph::weight(vertex_handle vertex1, vertex_handle vertex2) const] Edge between vertex with id " + static_cast<std::string>(m_vertices[vertex1].get_id()) + " and vertex with id " + static_cast<std::string>(m_vertices[vertex2].get_id()) + " not found"};
+            }
+
+            return m_weights[it - m_targets.begin()];
+        }
+
+        float &weight(vertex_handle vertex1, vertex_handle vertex2)
+        {
+            return const_cast<float &>(std::as_const(*this).weight(vertex1, vertex2));
+        }
+
+        const float &weight(const uuid &vertex1, const uuid &vertex2) const { return weight(handle(vertex1), handle(vertex2)); }
+        float &weight(const uuid &vertex1, const uuid &vertex2) { return weight(handle(vertex1), handle(vertex2)); }
+
+        size_t size() const { return m_vertices.size(); }
+        size_t size(vertex_handle vertex) const
+        {
+            if (!contains(vertex))
+            {
+                throw std::out_of_range{"[size_t sgl::CSRGraph::size(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+            }
+            return m_offsets[vertex + 1] - m_offsets[vertex];
+        }
+        size_t size(const uuid &id) const { return size(handle(id)); }
+
+        vertex_handle handle_bound() const { return static_cast<vertex_handle>(m_vertices.size()); }
+
+#if SGL_INSTRUMENT
+        std::pmr::memory_resource *resource() const { return m_counting_resource.upstream(); }
+        Stats &stats() const { return m_stats; }
+#else
+        std::pmr::memory_resource *resource() const { return m_resource; }
+        Stats &stats() const { return Stats::none(); }
+#endif
+
+        void shrink_to_fit()
+        {
+            const bool owned = m_offsets.data() == m_offset_storage.data();
+            m_vertices.shrink_to_fit();
+            m_offset_storage.shrink_to_fit();
+            m_target_storage.shrink_to_fit();
+            m_weight_storage.shrink_to_fit();
+            m_index.rehash(0);
+            if (owned)
+            {
+                use_storage();
+            }
+        }
+
+        void clear()
+        {
+            m_vertices.clear();
+            m_offset_storage.assign(1, 0);
+            m_target_storage.clear();
+            m_weight_storage.clear();
+            m_index.clear();
+            use_storage();
+        }
+
+        std::ostream &print(std::ostream &os = std::cout) const
+        {
+            for (auto it = cbegin(); it != cend(); ++it)
+            {
+                os << *it << std::endl;
+            }
+            return os;
+        }
+
+        template <VisitPolicy policy = VisitPolicy::RELATED,
+                  template <typename> typename ALGORITHM, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(ALGORITHM<CSRGraph<DATA_TYPE>> &algorithm, const uuid &id, FUNCTION function, ARGS &&...args)
+        {
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(const uuid &id, FUNCTION function, ARGS &&...args)
+        {
+            ALGORITHM<CSRGraph<DATA_TYPE>> algorithm;
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(FUNCTION function, ARGS &&...args)
+        {
+            ALGORITHM<CSRGraph<DATA_TYPE>> algorithm;
+            const uuid id = size() == 0 ? uuid{} : cbegin()->get_id();
+            return algorithm.template traverse<policy>(*this, id, function,
+                                                std::forward<ARGS>(args)...);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED>
+        auto traverse(const uuid &id)
+        {
+            ALGORITHM<CSRGraph<DATA_TYPE>> algorithm;
+            return algorithm.template traverse<policy>(*this, id,
+                                                [](const VERTEX_TYPE &vertex)
+                                                {
+                                                    std::cout << vertex << std::endl;
+                                                });
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED>
+        auto traverse()
+        {
+            ALGORITHM<CSRGraph<DATA_TYPE>> algorithm;
+            const uuid id = size() == 0 ? uuid{} : cbegin()->get_id();
+            return algorithm.template traverse<policy>(*this, id,
+                                                [](const VERTEX_TYPE &vertex)
+                                                {
+                                                    std::cout << vertex << std::endl;
+                                                });
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const CSRGraph &csr_graph)
+        {
+            return csr_graph.print(os);
+        }
+
+        const_iterator cbegin() const { return m_vertices.cbegin(); }
+        const_iterator cend() const { return m_vertices.cend(); }
+        const_iterator begin() const { return cbegin(); }
+        const_iterator end() const { return cend(); }
+        iterator begin() { return m_vertices.begin(); }
+        iterator end() { return m_vertices.end(); }
+
+        const_neighbor_iterator cbegin(vertex_handle vertex) const { return const_neighbor_iterator{m_targets.data() + m_offsets[vertex], m_weights.data() + m_offsets[vertex], m_vertices.data()}; }
+        const_neighbor_iterator cend(vertex_handle vertex) const { return const_neighbor_iterator{m_targets.data() + m_offsets[vertex + 1], m_weights.data() + m_offsets[vertex + 1], m_vertices.data()}; }
+        const_neighbor_iterator begin(vertex_handle vertex) const { return cbegin(vertex); }
+        const_neighbor_iterator end(vertex_handle vertex) const { return cend(vertex); }
+        neighbor_iterator begin(vertex_handle vertex) { return neighbor_iterator{m_targets.data() + m_offsets[vertex], m_weights.data() + m_offsets[vertex], m_vertices.data()}; }
+        neighbor_iterator end(vertex_handle vertex) { return neighbor_iterator{m_targets.data() + m_offsets[vertex + 1], m_weights.data() + m_offsets[vertex + 1], m_vertices.data()}; }
+
+    public:
+        template <bool IS_CONST>
+        class basic_neighbor_iterator
+        {
+            using weight_pointer = std::conditional_t<IS_CONST, const float *, float *>;
+            using storage_pointer = std::conditional_t<IS_CONST, const VERTEX_TYPE *, VERTEX_TYPE *>;
+
+            friend class CSRGraph;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = VERTEX_TYPE;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IS_CONST, const VERTEX_TYPE *, VERTEX_TYPE *>;
+            using reference = std::conditional_t<IS_CONST, const VERTEX_TYPE &, VERTEX_TYPE &>;
+
+            basic_neighbor_iterator() = default;
+
+            reference operator*() const { return m_vertices[*m_target]; }
+            pointer operator->() const { return m_vertices + *m_target; }
+
+            vertex_handle handle() const { return *m_target; }
+            float weight() const { return *m_weight; }
+
+            basic_neighbor_iterator &operator++()
+            {
+                ++m_target;
+                ++m_weight;
+                return *this;
+            }
+            basic_neighbor_iterator operator++(int)
+            {
+                basic_neighbor_iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(const basic_neighbor_iterator &other) const { return m_target == other.m_target; }
+
+        private:
+            basic_neighbor_iterator(const vertex_handle *target, weight_pointer weight, storage_pointer vertices)
+                : m_target{target}, m_weight{weight}, m_vertices{vertices} {}
+
+            const vertex_handle *m_target = nullptr;
+            weight_pointer m_weight = nullptr;
+            storage_pointer m_vertices = nullptr;
+        };
+    };
+
+    // true if TYPE is a traversal algorithm instantiated for DATA_STRUCTURE,
+    // such as ParallelBFS<AdjacencyList<int>>
+    template <typename TYPE, typename DATA_STRUCTURE>
+    struct is_algorithm : std::false_type
+    {
+    };
+    template <template <typename> typename ALGORITHM, typename DATA_STRUCTURE>
+    struct is_algorithm<ALGORITHM<DATA_STRUCTURE>, DATA_STRUCTURE> : std::true_type
+    {
+    };
+
+    template <typename DATA_TYPE,
+              template <typename> typename DATA_STRUCTURE = AdjacencyList>
+    class Graph
+    {
+    public:
+        using VERTEX_TYPE = Vertex<DATA_TYPE, DATA_STRUCTURE>;
+
+        using iterator = typename DATA_STRUCTURE<DATA_TYPE>::iterator;
+        using const_iterator = typename DATA_STRUCTURE<DATA_TYPE>::const_iterator;
+        using neighbor_iterator = typename DATA_STRUCTURE<DATA_TYPE>::neighbor_iterator;
+        using const_neighbor_iterator = typename DATA_STRUCTURE<DATA_TYPE>::const_neighbor_iterator;
+
+        static_assert(std::forward_iterator<iterator> && std::forward_iterator<const_iterator>);
+        static_assert(std::forward_iterator<neighbor_iterator> && std::forward_iterator<const_neighbor_iterator>);
+
+        friend class VertexPrinter;
+
+        template <typename OTHER_DATA_TYPE, template <typename> typename OTHER_DATA_STRUCTURE>
+        friend class Graph;
+        template <typename OTHER_DATA_TYPE>
+        friend class io::MappedGraph;
+
+        Graph() : Graph(std::pmr::get_default_resource()) {}
+        // vertices, edges and the lookup tables of the graph are allocated
+        // from resource, which has to outlive the graph
+        explicit Graph(std::pmr::memory_resource *resource) : m_data_structure{new DATA_STRUCTURE<DATA_TYPE>{resource}} {}
+        explicit Graph(const uuid_generator &generator) : Graph()
+        {
+            m_data_structure->m_generator = generator;
+        }
+        // copies the vertices, with their ids, and the edges of a graph stored
+        // in another data structure, allocating from the same memory resource
+        template <template <typename> typename OTHER_DATA_STRUCTURE>
+        explicit Graph(const Graph<DATA_TYPE, OTHER_DATA_STRUCTURE> &other) : Graph(other.resource())
+        {
+            m_data_structure->assign(other);
+        }
+        ~Graph() = default;
+
+        // immutable snapshot for read-heavy workloads, see CSRGraph
+        Graph<DATA_TYPE, CSRGraph> freeze() const { return copy<CSRGraph>(); }
+
+        // mutable copy of the graph, vertex ids are preserved by freeze and thaw
+        template <template <typename> typename OTHER_DATA_STRUCTURE = AdjacencyList>
+        Graph<DATA_TYPE, OTHER_DATA_STRUCTURE> thaw() const { return copy<OTHER_DATA_STRUCTURE>(); }
+
+        const uuid &add_vertex(VERTEX_TYPE &&vertex)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            return m_data_structure->add_vertex(std::forward<VERTEX_TYPE>(vertex));
+        }
+        template <template <typename> typename OTHER_DATA_STRUCTURE>
+        const uuid &add_vertex(const Vertex<DATA_TYPE, OTHER_DATA_STRUCTURE> &vertex)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            DATA_TYPE copy = vertex.data();
+            return m_data_structure->add_vertex(std::move(copy));
+        }
+        const uuid &add_vertex(DATA_TYPE &&data)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            return m_data_structure->add_vertex(std::forward<DATA_TYPE>(data));
+        }
+        const uuid &add_vertex(DATA_TYPE &data)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            DATA_TYPE copy = data;
+            return m_data_structure->add_vertex(std::move(copy));
+        }
+        void add_edge(const uuid &vertex1_id, const uuid &vertex2_id, const float weight = 0)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            m_data_structure->add_edge(vertex1_id, vertex2_id, weight);
+        }
+        void add_edge(vertex_handle vertex1, vertex_handle vertex2, const float weight = 0)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            m_data_structure->add_edge(vertex1, vertex2, weight);
+        }
+        void remove_edge(const uuid &vertex1_id, const uuid &vertex2_id)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::REMOVAL);
+            m_data_structure->remove_edge(vertex1_id, vertex2_id);
+        }
+        void remove_vertex(const uuid &vertex_id)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::REMOVAL);
+            m_data_structure->remove_vertex(vertex_id);
+        }
+
+        template <typename FUNCTION, typename... ARGS>
+        void remove_if(FUNCTION function, ARGS &&...args)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::REMOVAL);
+            m_data_structure->remove_if(function, std::forward<ARGS>(args)...);
+        }
+
+        // Batch operations for building and editing large graphs, the whole
+        // batch is checked before the graph is modified and either all of it
+        // is applied or none. Vertices are given by id or handle, the edges
+        // by any element with three members or tuple elements, such as Edge
+        // or std::tuple<uuid, uuid, float>.
+        template <typename RANGE>
+        std::vector<uuid> add_vertices(const RANGE &data)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            return m_data_structure->add_vertices(data);
+        }
+        template <typename RANGE>
+        void add_edges(const RANGE &edges, DuplicatePolicy policy = DuplicatePolicy::REJECT)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::CONSTRUCTION);
+            std::vector<Edge> batch;
+            if constexpr (std::ranges::sized_range<const RANGE>)
+            {
+                batch.reserve(std::ranges::size(edges));
+            }
+            for (const auto &[vertex1, vertex2, weight] : edges)
+            {
+                batch.push_back(Edge{to_handle(vertex1), to_handle(vertex2), static_cast<float>(weight)});
+            }
+            m_data_structure->add_edges(std::move(batch), policy);
+        }
+        template <typename RANGE>
+        void remove_vertices(const RANGE &vertices)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::REMOVAL);
+            std::vector<vertex_handle> batch;
+            if constexpr (std::ranges::sized_range<const RANGE>)
+            {
+                batch.reserve(std::ranges::size(vertices));
+            }
+            for (const auto &vertex : vertices)
+            {
+                batch.push_back(to_handle(vertex));
+            }
+            m_data_structure->remove_vertices(std::move(batch));
+        }
+
+        vertex_handle handle(const uuid &id) const { return m_data_structure->handle(id); }
+
+        const VERTEX_TYPE &vertex(const uuid &id) const { return m_data_structure->vertex(id); }
+        VERTEX_TYPE &vertex(const uuid &id) { return m_data_structure->vertex(id); }
+        const VERTEX_TYPE &vertex(vertex_handle handle) const { return m_data_structure->vertex(handle); }
+        VERTEX_TYPE &vertex(vertex_handle handle) { return m_data_structure->vertex(handle); }
+        const VERTEX_TYPE &operator()(const uuid &id) const { return m_data_structure->vertex(id); }
+        VERTEX_TYPE &operator()(const uuid &id) { return m_data_structure->vertex(id); }
+        const float &get_weight(const uuid &vertex1, const uuid &vertex2) const { return m_data_structure->weight(vertex1, vertex2); }
+        const float &get_weight(vertex_handle vertex1, vertex_handle vertex2) const { return m_data_structure->weight(vertex1, vertex2); }
+        void set_weight(const uuid &vertex1, const uuid &vertex2, const float weight)
+        {
+            m_data_structure->weight(vertex1, vertex2) = weight;
+            m_data_structure->weight(vertex2, vertex1) = weight;
+        }
+
+        size_t size() const { return m_data_structure->size(); }
+        size_t size(const uuid &id) const { return m_data_structure->size(id); }
+        vertex_handle handle_bound() const { return m_data_structure->handle_bound(); }
+
+        std::pmr::memory_resource *resource() const { return m_data_structure->resource(); }
+
+        // counters of this graph, all zero unless SGL_INSTRUMENT is defined
+        // as 1, see Stats
+        Stats &stats() const { return m_data_structure->stats(); }
+
+        // preallocates room for the given number of vertices and edges, so
+        // building a graph of known size does not reallocate
+        void reserve(size_t vertices, size_t edges = 0) { m_data_structure->reserve(vertices, edges); }
+        // releases memory held for removed vertices and unused capacity
+        void shrink_to_fit() { m_data_structure->shrink_to_fit(); }
+
+        // dense kernels, only available for data structures that provide them
+        // (AdjacencyMatrix) and constrained so that callers can detect them
+        size_t common_neighbors(const uuid &vertex1, const uuid &vertex2) const
+            requires requires(const DATA_STRUCTURE<DATA_TYPE> &data_structure) { data_structure.common_neighbors(vertex_handle{}, vertex_handle{}); }
+        {
+            return m_data_structure->common_neighbors(handle(vertex1), handle(vertex2));
+        }
+        size_t triangles(const uuid &id) const
+            requires requires(const DATA_STRUCTURE<DATA_TYPE> &data_structure) { data_structure.triangles(vertex_handle{}); }
+        {
+            return m_data_structure->triangles(handle(id));
+        }
+        size_t triangles() const
+            requires requires(const DATA_STRUCTURE<DATA_TYPE> &data_structure) { data_structure.triangles(); }
+        {
+            return m_data_structure->triangles();
+        }
+        template <typename INPUT_ITERATOR, typename OUTPUT_ITERATOR>
+        OUTPUT_ITERATOR get_weights(const uuid &id, INPUT_ITERATOR first, INPUT_ITERATOR last, OUTPUT_ITERATOR out) const
+            requires requires(const DATA_STRUCTURE<DATA_TYPE> &data_structure) { data_structure.weights(vertex_handle{}, first, last, out); }
+        {
+            return m_data_structure->weights(handle(id), first, last, out);
+        }
+        void clear() { m_data_structure->clear(); }
+
+        std::ostream &print(std::ostream &os = std::cout) const
+        {
+            return m_data_structure->print(os);
+        }
+
+        // the algorithm an ALGORITHM template runs as on this graph, to be
+        // constructed with its options and passed to traverse, such as
+        // Graph<int>::algorithm<ParallelBFS>{threads}
+        template <template <typename> typename ALGORITHM>
+        using algorithm = ALGORITHM<DATA_STRUCTURE<DATA_TYPE>>;
+
+        template <VisitPolicy policy = VisitPolicy::RELATED,
+                  template <typename> typename ALGORITHM, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(ALGORITHM<DATA_STRUCTURE<DATA_TYPE>> algorithm, const uuid &id, FUNCTION function, ARGS &&...args)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::TRAVERSAL);
+            return m_data_structure->template traverse<policy>(
+                algorithm, id, function, std::forward<ARGS>(args)...);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(const uuid &id, FUNCTION function, ARGS &&...args)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::TRAVERSAL);
+            return m_data_structure->template traverse<ALGORITHM, policy>(
+                id, function, std::forward<ARGS>(args)...);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(FUNCTION function, ARGS &&...args)
+            requires(!is_algorithm<FUNCTION, DATA_STRUCTURE<DATA_TYPE>>::value)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::TRAVERSAL);
+            return m_data_structure->template traverse<ALGORITHM, policy>(
+                function, std::forward<ARGS>(args)...);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED>
+        auto traverse(const uuid &id)
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::TRAVERSAL);
+            return m_data_structure->template traverse<ALGORITHM, policy>(id);
+        }
+
+        template <template <typename> typename ALGORITHM = BFS,
+                  VisitPolicy policy = VisitPolicy::RELATED>
+        auto traverse()
+        {
+            SGL_TIME(m_data_structure->stats(), Phase::TRAVERSAL);
+            return m_data_structure->template traverse<ALGORITHM, policy>();
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const Graph &graph)
+        {
+            return os << *graph.m_data_structure;
+        }
+
+    private:
+        std::shared_ptr<DATA_STRUCTURE<DATA_TYPE>> m_data_structure;
+
+        // Graph<DATA_TYPE, OTHER_DATA_STRUCTURE>{*this} would pick the copy
+        // constructor when the data structures are the same, which shares
+        // m_data_structure instead of copying it
+        template <template <typename> typename OTHER_DATA_STRUCTURE>
+        Graph<DATA_TYPE, OTHER_DATA_STRUCTURE> copy() const
+        {
+            Graph<DATA_TYPE, OTHER_DATA_STRUCTURE> graph{resource()};
+            graph.assign(*this);
+            return graph;
+        }
+
+        template <typename OTHER_GRAPH>
+        void assign(const OTHER_GRAPH &other) { m_data_structure->assign(other); }
+
+        vertex_handle to_handle(const uuid &id) const { return handle(id); }
+        vertex_handle to_handle(vertex_handle handle) const { return handle; }
+
+    public:
+        const_iterator begin() const { return m_data_structure->cbegin(); }
+        const_iterator end() const { return m_data_structure->cend(); }
+        iterator begin() { return m_data_structure->begin(); }
+        iterator end() { return m_data_structure->end(); }
+
+        const_neighbor_iterator begin(const uuid &id) const { return m_data_structure->cbegin(m_data_structure->handle(id)); }
+        const_neighbor_iterator end(const uuid &id) const { return m_data_structure->cend(m_data_structure->handle(id)); }
+        neighbor_iterator begin(const uuid &id) { return m_data_structure->begin(m_data_structure->handle(id)); }
+        neighbor_iterator end(const uuid &id) { return m_data_structure->end(m_data_structure->handle(id)); }
+    };
+
+    template <typename DATA_STRUCTURE>
+    class BFS
+    {
+        using VERTEX_TYPE = typename DATA_STRUCTURE::VERTEX_TYPE;
+
+    public:
+        BFS() = default;
+        ~BFS() = default;
+
+        template <VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(DATA_STRUCTURE &data_structure, const uuid &id,
+                      FUNCTION &&function, ARGS &&...args)
+        {
+            if (data_structure.size() == 0)
+            {
+                throw std::out_of_range{"[void sgl::BFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Graph is empty"};
+            }
+
+            std::queue<vertex_handle> queue;
+            std::vector<bool> visited(data_structure.handle_bound(), false);
+
+            try
+            {
+                VERTEX_TYPE &start_vertex = data_structure.vertex(id);
+                queue.push(start_vertex.get_handle());
+                visited[start_vertex.get_handle()] = true;
+            }
+            catch (const std::out_of_range &e)
+            {
+                throw std::out_of_range{"[void sgl::BFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Vertex with id " + static_cast<std::string>(id) + " not found"};
+            }
+
+            while (!queue.empty())
+            {
+
+                VERTEX_TYPE &vertex = data_structure.vertex(queue.front());
+                queue.pop();
+
+                function(vertex, std::forward<ARGS>(args)...);
+                SGL_COUNT(data_structure.stats(), vertices_visited, 1);
+
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                {
+                    if (!visited[it.handle()])
+                    {
+                        visited[it.handle()] = true;
+                        queue.push(it.handle());
+                    }
+                }
+            }
+
+            if constexpr (policy)
+            {
+                for (auto &vertex : data_structure)
+                {
+                    if (!visited[vertex.get_handle()])
+                    {
+                        function(vertex, std::forward<ARGS>(args)...);
+                        SGL_COUNT(data_structure.stats(), vertices_visited, 1);
+                    }
+                }
+            }
+        }
+    };
+
+    template <typename DATA_STRUCTURE>
+    class DFS
+    {
+        using VERTEX_TYPE = typename DATA_STRUCTURE::VERTEX_TYPE;
+
+    public:
+        DFS() = default;
+        ~DFS() = default;
+
+        template <VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        auto traverse(DATA_STRUCTURE &data_structure, const uuid &id,
+                      FUNCTION &&function, ARGS &&...args)
+        {
+            if (data_structure.size() == 0)
+            {
+                throw std::out_of_range{"[void sgl::DFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Graph is empty"};
+            }
+
+            std::stack<vertex_handle> stack;
+            std::vector<bool> visited(data_structure.handle_bound(), false);
+
+            try
             {
                 VERTEX_TYPE &start_vertex = data_structure.vertex(id);
-                queue.push(start_vertex.get_id());
-                visited.insert(start_vertex.get_id());
+                stack.push(start_vertex.get_handle());
+                visited[start_vertex.get_handle()] = true;
+            }
+            catch (const std::out_of_range &e)
+            {
+                throw std::out_of_range{"[void sgl::DFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Vertex with id " + static_cast<std::string>(id) + " not found"};
+            }
+
+            while (!stack.empty())
+            {
+                VERTEX_TYPE &vertex = data_structure.vertex(stack.top());
+                stack.pop();
+
+                function(vertex, std::forward<ARGS>(args)...);
+                SGL_COUNT(data_structure.stats(), vertices_visited, 1);
+
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                {
+                    if (!visited[it.handle()])
+                    {
+                        visited[it.handle()] = true;
+                        stack.push(it.handle());
+                    }
+                }
+            }
+
+            if constexpr (policy)
+            {
+                for (auto &vertex : data_structure)
+                {
+                    if (!visited[vertex.get_handle()])
+                    {
+                        function(vertex, std::forward<ARGS>(args)...);
+                        SGL_COUNT(data_structure.stats(), vertices_visited, 1);
+                    }
+                }
+            }
+        }
+    };
+
+    // Result of a ParallelBFS traversal, the arrays are indexed by vertex handle.
+    struct BFSTree
+    {
+        static constexpr vertex_handle no_parent = std::numeric_limits<vertex_handle>::max();
+        static constexpr std::uint32_t unreached = std::numeric_limits<std::uint32_t>::max();
+
+        // handle the vertex was discovered from, the start vertex is its own
+        // parent, no_parent if the vertex was not reached
+        std::vector<vertex_handle> parent;
+        // number of edges on the path from the start vertex, unreached if the
+        // vertex was not reached
+        std::vector<std::uint32_t> depth;
+        // reached vertices level by level, level d is
+        // order[level_offsets[d]] .. order[level_offsets[d + 1] - 1]
+        std::vector<vertex_handle> order;
+        std::vector<size_t> level_offsets;
+
+        size_t levels() const { return level_offsets.size() - 1; }
+    };
+
+    // Level-synchronous breadth-first search on a pool of std::threads.
+    //
+    // Each level is one parallel loop. Small frontiers are expanded top-down,
+    // the frontier pushes its unvisited neighbors. Once the edges of the
+    // frontier outweigh the unexplored ones the level is expanded bottom-up,
+    // every unvisited vertex looks for a neighbor in the frontier instead, and
+    // it switches back when the frontier shrinks again. Visited state is an
+    // atomic bitmap and the loops are cut into chunks that idle threads steal
+    // from the others.
+    //
+    // Guarantees for the visiting function:
+    //  - it is called exactly once for every reached vertex
+    //  - calls for vertices of the same level may run concurrently on
+    //    different threads, in any order, but never twice at the same time for
+    //    the same vertex
+    //  - every call for level d returns before the first call for level d + 1
+    //  - with VisitPolicy::ALL the unreached vertices are visited after the
+    //    last level, concurrently with each other
+    // The function may modify the data of the vertex it is given, access to
+    // anything else it shares between calls (other vertices included) must be
+    // synchronized by the caller, and the graph must not be modified during the
+    // traversal. If it throws, the traversal stops at the end of the level and
+    // the first exception is rethrown.
+    template <typename DATA_STRUCTURE>
+    class ParallelBFS
+    {
+        using VERTEX_TYPE = typename DATA_STRUCTURE::VERTEX_TYPE;
+
+        using word_type = std::uint64_t;
+        static constexpr size_t word_bits = 64;
+
+        // Beamer's direction-optimizing thresholds: go bottom-up when the
+        // frontier has more than 1/alpha of the unexplored edges, go back
+        // top-down when it has less than 1/beta of the vertices
+        static constexpr size_t alpha = 14;
+        static constexpr size_t beta = 24;
+
+        // vertices per thread below which more threads do not pay off
+        static constexpr size_t min_vertices_per_thread = 256;
+
+    public:
+        // graph.traverse<ParallelBFS>(...) uses every hardware thread, pass
+        // Graph::algorithm<ParallelBFS>{threads} to traverse to limit them
+        ParallelBFS() : ParallelBFS(std::thread::hardware_concurrency()) {}
+        explicit ParallelBFS(unsigned threads) : m_threads{std::max(threads, 1u)} {}
+        ~ParallelBFS() = default;
+
+        template <VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
+                  typename... ARGS>
+        BFSTree traverse(DATA_STRUCTURE &data_structure, const uuid &id,
+                         FUNCTION &&function, ARGS &&...args)
+        {
+            if (data_structure.size() == 0)
+            {
+                throw std::out_of_range{"[BFSTree sgl::ParallelBFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Graph is empty"};
+            }
+
+            vertex_handle start;
+            try
+            {
+                start = data_structure.vertex(id).get_handle();
+            }
+            catch (const std::out_of_range &e)
+            {
+                throw std::out_of_range{"[BFSTree sgl::ParallelBFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Vertex with id " + static_cast<std::string>(id) + " not found"};
+            }
+
+            const size_t bound = data_structure.handle_bound();
+            const unsigned threads = static_cast<unsigned>(std::min<size_t>(m_threads, (bound + min_vertices_per_thread - 1) / min_vertices_per_thread));
+
+            // everything the workers append to is reserved up front, so that
+            // the serial step between levels cannot throw
+            BFSTree tree;
+            tree.parent.assign(bound, BFSTree::no_parent);
+            tree.depth.assign(bound, BFSTree::unreached);
+            tree.order.reserve(bound);
+            tree.level_offsets.reserve(bound + 2);
+
+            std::vector<std::atomic<word_type>> visited((bound + word_bits - 1) / word_bits);
+            std::vector<word_type> frontier((bound + word_bits - 1) / word_bits);
+
+            tree.parent[start] = start;
+            tree.depth[start] = 0;
+            tree.order.push_back(start);
+            tree.level_offsets.push_back(0);
+            tree.level_offsets.push_back(1);
+            visited[start / word_bits].fetch_or(word_type{1} << (start % word_bits), std::memory_order_relaxed);
+
+            size_t unexplored_edges = 0;
+            for (auto &vertex : data_structure)
+            {
+                unexplored_edges += vertex.size();
+            }
+            unexplored_edges -= data_structure.size(start);
+
+            struct alignas(64) worker_state
+            {
+                std::vector<vertex_handle> next;
+                size_t next_edges = 0;
+            };
+            std::vector<worker_state> workers(threads);
+
+            enum class step
+            {
+                TOP_DOWN,
+                BOTTOM_UP,
+                UNREACHED
+            };
+            step current = step::TOP_DOWN;
+            std::uint32_t level = 0;
+            bool done = false;
+
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+
+            work_queue queue{threads};
+            queue.reset(1);
+
+            auto is_visited = [&visited](vertex_handle handle)
+            {
+                return (visited[handle / word_bits].load(std::memory_order_relaxed) & (word_type{1} << (handle % word_bits))) != 0;
+            };
+            auto in_frontier = [&frontier](vertex_handle handle)
+            {
+                return (frontier[handle / word_bits] & (word_type{1} << (handle % word_bits))) != 0;
+            };
+
+            auto discover = [&](worker_state &worker, vertex_handle handle, vertex_handle parent)
+            {
+                tree.parent[handle] = parent;
+                tree.depth[handle] = level + 1;
+                worker.next.push_back(handle);
+                worker.next_edges += data_structure.size(handle);
+            };
+
+            auto process = [&](unsigned id)
+            {
+                worker_state &worker = workers[id];
+                const size_t frontier_begin = tree.level_offsets[level];
+                const size_t frontier_size = tree.level_offsets[level + 1] - frontier_begin;
+
+                queue.run(id, [&](size_t first, size_t last)
+                          {
+                    if (failed.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+
+                    for (size_t item = first; item < last; ++item)
+                    {
+                        if (current == step::UNREACHED)
+                        {
+                            vertex_handle handle = static_cast<vertex_handle>(item);
+                            if (data_structure.contains(handle) && !is_visited(handle))
+                            {
+                                function(data_structure.vertex(handle), args...);
+                            }
+                        }
+                        else if (item < frontier_size)
+                        {
+                            vertex_handle handle = tree.order[frontier_begin + item];
+                            VERTEX_TYPE &vertex = data_structure.vertex(handle);
+                            function(vertex, args...);
+
+                            if (current == step::TOP_DOWN)
+                            {
+                                for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                                {
+                                    word_type bit = word_type{1} << (it.handle() % word_bits);
+                                    std::atomic<word_type> &word = visited[it.handle() / word_bits];
+                                    if ((word.load(std::memory_order_relaxed) & bit) == 0 && (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0)
+                                    {
+                                        discover(worker, it.handle(), handle);
+                                    }
+                                }
+                            }
+                        }
+                        else
+                        {
+                            // bottom-up, only this thread looks at this handle
+                            vertex_handle handle = static_cast<vertex_handle>(item - frontier_size);
+                            if (!data_structure.contains(handle) || is_visited(handle))
+                            {
+                                continue;
+                            }
+
+                            VERTEX_TYPE &vertex = data_structure.vertex(handle);
+                            for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                            {
+                                if (in_frontier(it.handle()))
+                                {
+                                    visited[handle / word_bits].fetch_or(word_type{1} << (handle % word_bits), std::memory_order_relaxed);
+                                    discover(worker, handle, it.handle());
+                                    break;
+                                }
+                            }
+                        }
+                    } });
+            };
+
+            // runs on one thread while the others wait at the barrier
+            auto next_level = [&]() noexcept
+            {
+                if (failed.load(std::memory_order_relaxed) || current == step::UNREACHED)
+                {
+                    done = true;
+                    return;
+                }
+
+                const size_t frontier_size = tree.level_offsets[level + 1] - tree.level_offsets[level];
+                size_t next_edges = 0;
+                for (auto &worker : workers)
+                {
+                    tree.order.insert(tree.order.end(), worker.next.begin(), worker.next.end());
+                    next_edges += worker.next_edges;
+                    worker.next.clear();
+                    worker.next_edges = 0;
+                }
+                const size_t next_size = tree.order.size() - tree.level_offsets.back();
+
+                if (next_size == 0)
+                {
+                    if (policy == VisitPolicy::ALL && tree.order.size() < data_structure.size())
+                    {
+                        current = step::UNREACHED;
+                        queue.reset(bound);
+                    }
+                    else
+                    {
+                        done = true;
+                    }
+                    return;
+                }
+
+                tree.level_offsets.push_back(tree.order.size());
+                ++level;
+
+                unexplored_edges -= std::min(unexplored_edges, next_edges);
+                if (current == step::TOP_DOWN && next_edges > unexplored_edges / alpha)
+                {
+                    current = step::BOTTOM_UP;
+                }
+                else if (current == step::BOTTOM_UP && next_size < bound / beta && next_size < frontier_size)
+                {
+                    current = step::TOP_DOWN;
+                }
+
+                if (current == step::BOTTOM_UP)
+                {
+                    std::fill(frontier.begin(), frontier.end(), word_type{0});
+                    for (size_t i = tree.level_offsets[level]; i < tree.order.size(); ++i)
+                    {
+                        frontier[tree.order[i] / word_bits] |= word_type{1} << (tree.order[i] % word_bits);
+                    }
+                    queue.reset(next_size + bound);
+                }
+                else
+                {
+                    queue.reset(next_size);
+                }
+            };
+
+            std::barrier sync{static_cast<std::ptrdiff_t>(threads), next_level};
+
+            auto run = [&](unsigned id)
+            {
+                while (true)
+                {
+                    try
+                    {
+                        process(id);
+                    }
+                    catch (...)
+                    {
+                        if (!failed.exchange(true))
+                        {
+                            error = std::current_exception();
+                        }
+                    }
+
+                    sync.arrive_and_wait();
+                    if (done)
+                    {
+                        return;
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+            try
+            {
+                for (unsigned id = 1; id < threads; ++id)
+                {
+                    pool.emplace_back(run, id);
+                }
+            }
+            catch (const std::system_error &e)
+            {
+                // the chunks of the missing threads are stolen by the others
+                for (size_t id = pool.size() + 1; id < threads; ++id)
+                {
+                    sync.arrive_and_drop();
+                }
+            }
+
+            run(0);
+            for (auto &thread : pool)
+            {
+                thread.join();
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+
+            SGL_COUNT(data_structure.stats(), vertices_visited, policy == VisitPolicy::ALL ? data_structure.size() : tree.order.size());
+            return tree;
+        }
+
+    private:
+        // [0, count) cut into chunks which are dealt out to the workers in
+        // contiguous shares, a worker drains its own share first and then
+        // steals the chunks left in the shares of the others
+        class work_queue
+        {
+        public:
+            explicit work_queue(unsigned workers) : m_shares(workers) {}
+
+            void reset(size_t count)
+            {
+                const size_t workers = m_shares.size();
+                m_count = count;
+                m_chunk = std::clamp<size_t>(count / (workers * 16), 64, 4096);
+
+                const size_t chunks = (count + m_chunk - 1) / m_chunk;
+                for (size_t i = 0; i < workers; ++i)
+                {
+                    m_shares[i].next.store(chunks * i / workers, std::memory_order_relaxed);
+                    m_shares[i].end = chunks * (i + 1) / workers;
+                }
             }
-            catch (const std::out_of_range &e)
+
+            template <typename BODY>
+            void run(unsigned worker, BODY &&body)
             {
-                throw std::out_of_range{"[void sgl::BFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Vertex with id " + static_cast<std::string>(id) + " not found"};
+                for (size_t i = 0; i < m_shares.size(); ++i)
+                {
+                    share &victim = m_shares[(worker + i) % m_shares.size()];
+                    for (size_t chunk = victim.next.fetch_add(1, std::memory_order_relaxed); chunk < victim.end;
+                         chunk = victim.next.fetch_add(1, std::memory_order_relaxed))
+                    {
+                        body(chunk * m_chunk, std::min(m_count, (chunk + 1) * m_chunk));
+                    }
+                }
             }
 
-            while (!queue.empty())
+        private:
+            struct alignas(64) share
             {
+                std::atomic<size_t> next{0};
+                size_t end = 0;
+            };
 
-                VERTEX_TYPE &vertex = data_structure.vertex(queue.front());
-                queue.pop();
+            std::vector<share> m_shares;
+            size_t m_count = 0;
+            size_t m_chunk = 1;
+        };
 
-                function(vertex, std::forward<ARGS>(args)...);
+        unsigned m_threads;
+    };
+
+    // Result of a single source shortest path query, indexed by vertex handle.
+    // Paths are not stored, they are rebuilt from the parent array on request.
+    class ShortestPaths
+    {
+        template <typename GRAPH>
+        friend class PathFinder;
+
+    public:
+        static constexpr vertex_handle no_parent = std::numeric_limits<vertex_handle>::max();
+
+        vertex_handle source() const { return m_source; }
+
+        // infinity if the vertex was not reached
+        float distance(vertex_handle vertex) const { return vertex < m_distance.size() ? m_distance[vertex] : std::numeric_limits<float>::infinity(); }
+        // the source is its own parent, no_parent if the vertex was not reached
+        vertex_handle parent(vertex_handle vertex) const { return vertex < m_parent.size() ? m_parent[vertex] : no_parent; }
+        bool reached(vertex_handle vertex) const { return parent(vertex) != no_parent; }
+
+        // handles from the source to the target, empty if the target was not
+        // reached
+        std::vector<vertex_handle> path(vertex_handle target) const
+        {
+            std::vector<vertex_handle> path;
+            if (!reached(target))
+            {
+                return path;
+            }
+
+            for (vertex_handle vertex = target; vertex != m_source; vertex = m_parent[vertex])
+            {
+                path.push_back(vertex);
+            }
+            path.push_back(m_source);
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        const std::vector<float> &distances() const { return m_distance; }
+        const std::vector<vertex_handle> &parents() const { return m_parent; }
+
+    private:
+        // only the entries written by the previous query are cleared, so a
+        // query costs the part of the graph it explores, not the whole graph
+        void reset(vertex_handle source, size_t bound)
+        {
+            if (m_distance.size() != bound)
+            {
+                m_distance.assign(bound, std::numeric_limits<float>::infinity());
+                m_parent.assign(bound, no_parent);
+            }
+            else
+            {
+                for (auto &vertex : m_touched)
+                {
+                    m_distance[vertex] = std::numeric_limits<float>::infinity();
+                    m_parent[vertex] = no_parent;
+                }
+            }
+            m_touched.clear();
+
+            m_source = source;
+            update(source, 0, source);
+        }
+
+        void update(vertex_handle vertex, float distance, vertex_handle parent)
+        {
+            if (m_parent[vertex] == no_parent)
+            {
+                m_touched.push_back(vertex);
+            }
+            m_distance[vertex] = distance;
+            m_parent[vertex] = parent;
+        }
+
+        vertex_handle m_source = no_parent;
+        std::vector<float> m_distance;
+        std::vector<vertex_handle> m_parent;
+        std::vector<vertex_handle> m_touched;
+    };
+
+    // Result of a single pair shortest path query.
+    struct Path
+    {
+        // infinity if the target is not reachable from the source
+        float distance = std::numeric_limits<float>::infinity();
+        // handles from the source to the target, empty if the target is not
+        // reachable from the source
+        std::vector<vertex_handle> vertices;
+    };
+
+    // Shortest path queries on a graph with non-negative edge weights.
+    //
+    // A PathFinder keeps its distance arrays and heaps between queries, so
+    // running many queries on one PathFinder only pays for the vertices each
+    // query explores. The ShortestPaths returned by reference stay valid until
+    // the next query, the graph must not be modified while a PathFinder is in
+    // use.
+    template <typename GRAPH>
+    class PathFinder
+    {
+        using VERTEX_TYPE = typename GRAPH::VERTEX_TYPE;
+
+        // vertices per thread below which more threads do not pay off
+        static constexpr size_t min_vertices_per_thread = 256;
+
+    public:
+        explicit PathFinder(const GRAPH &graph) : m_graph{graph} {}
+        ~PathFinder() = default;
+
+        // Dijkstra's algorithm from the source to every reachable vertex.
+        const ShortestPaths &from(const uuid &source)
+        {
+            SGL_TIME(m_graph.stats(), Phase::SHORTEST_PATH);
+            search(m_forward, m_heap, resolve(source, "[const ShortestPaths &sgl::PathFinder::from(const uuid &source)]"), [](vertex_handle)
+                   { return false; });
+            return m_forward;
+        }
+
+        // Dijkstra's algorithm that stops once the target is settled. Only the
+        // distances of the target and of the vertices settled before it are
+        // final, the others are upper bounds.
+        const ShortestPaths &from(const uuid &source, const uuid &target)
+        {
+            SGL_TIME(m_graph.stats(), Phase::SHORTEST_PATH);
+            vertex_handle target_handle = resolve(target, "[const ShortestPaths &sgl::PathFinder::from(const uuid &source, const uuid &target)]");
+            search(m_forward, m_heap, resolve(source, "[const ShortestPaths &sgl::PathFinder::from(const uuid &source, const uuid &target)]"), [target_handle](vertex_handle vertex)
+                   { return vertex == target_handle; });
+            return m_forward;
+        }
+
+        // A* search, heuristic(const VERTEX_TYPE &vertex) must not overestimate
+        // the distance from the vertex to the target. As with from(source,
+        // target) only the distance of the target is guaranteed to be final.
+        template <typename HEURISTIC>
+        const ShortestPaths &astar(const uuid &source, const uuid &target, HEURISTIC &&heuristic)
+        {
+            SGL_TIME(m_graph.stats(), Phase::SHORTEST_PATH);
+            const vertex_handle source_handle = resolve(source, "[const ShortestPaths &sgl::PathFinder::astar(const uuid &source, const uuid &target, HEURISTIC &&heuristic)]");
+            const vertex_handle target_handle = resolve(target, "[const ShortestPaths &sgl::PathFinder::astar(const uuid &source, const uuid &target, HEURISTIC &&heuristic)]");
+            const size_t bound = m_graph.handle_bound();
+
+            // the heuristic is evaluated once per vertex and query, the
+            // previous estimates are cleared while they are still in range
+            for (auto &vertex : m_estimated)
+            {
+                m_estimates[vertex] = std::numeric_limits<float>::quiet_NaN();
+            }
+            m_estimated.clear();
+            m_estimates.resize(bound, std::numeric_limits<float>::quiet_NaN());
+
+            auto estimate = [&](vertex_handle vertex)
+            {
+                if (std::isnan(m_estimates[vertex]))
+                {
+                    m_estimates[vertex] = heuristic(m_graph.vertex(vertex));
+                    m_estimated.push_back(vertex);
+                }
+                return m_estimates[vertex];
+            };
+
+            m_forward.reset(source_handle, bound);
+            m_heap.reset(bound);
+            m_heap.push(source_handle, estimate(source_handle));
+
+            while (!m_heap.empty())
+            {
+                vertex_handle handle = m_heap.pop().second;
+                if (handle == target_handle)
+                {
+                    break;
+                }
 
-                for (auto it = data_structure.begin(vertex.get_id());
-                     it != data_structure.end(vertex.get_id()); ++it)
+                const float distance = m_forward.m_distance[handle];
+                const VERTEX_TYPE &vertex = m_graph.vertex(handle);
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
                 {
-                    if (visited.find(it->get_id()) == visited.end())
+                    SGL_COUNT(m_graph.stats(), edges_relaxed, 1);
+                    const float candidate = distance + it.weight();
+                    if (candidate < m_forward.m_distance[it.handle()])
                     {
-                        queue.push(it->get_id());
-                        visited.insert(it->get_id());
+                        m_forward.update(it.handle(), candidate, handle);
+                        m_heap.push(it.handle(), candidate + estimate(it.handle()));
                     }
                 }
             }
 
-            if constexpr (policy)
+            return m_forward;
+        }
+
+        // Dijkstra's algorithm run from both ends at once, the side with the
+        // smaller heap is expanded. It stops once the two heap minimums add up
+        // to the best path found through a vertex reached from both sides.
+        Path bidirectional(const uuid &source, const uuid &target)
+        {
+            SGL_TIME(m_graph.stats(), Phase::SHORTEST_PATH);
+            const vertex_handle source_handle = resolve(source, "[Path sgl::PathFinder::bidirectional(const uuid &source, const uuid &target)]");
+            const vertex_handle target_handle = resolve(target, "[Path sgl::PathFinder::bidirectional(const uuid &source, const uuid &target)]");
+            const size_t bound = m_graph.handle_bound();
+
+            m_forward.reset(source_handle, bound);
+            m_backward.reset(target_handle, bound);
+            m_heap.reset(bound);
+            m_backward_heap.reset(bound);
+            m_heap.push(source_handle, 0);
+            m_backward_heap.push(target_handle, 0);
+
+            float best = source_handle == target_handle ? 0 : std::numeric_limits<float>::infinity();
+            vertex_handle meeting = source_handle;
+
+            while (!m_heap.empty() && !m_backward_heap.empty() &&
+                   m_heap.top().first + m_backward_heap.top().first < best)
             {
-                for (auto it = data_structure.m_vertices.begin();
-                     it != data_structure.m_vertices.end(); ++it)
+                const bool forward = m_heap.size() <= m_backward_heap.size();
+                ShortestPaths &paths = forward ? m_forward : m_backward;
+                const ShortestPaths &other = forward ? m_backward : m_forward;
+                heap &queue = forward ? m_heap : m_backward_heap;
+
+                auto [distance, handle] = queue.pop();
+                const VERTEX_TYPE &vertex = m_graph.vertex(handle);
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
                 {
-                    if (visited.find(it->first) == visited.end())
+                    SGL_COUNT(m_graph.stats(), edges_relaxed, 1);
+                    const float candidate = distance + it.weight();
+                    if (candidate < paths.m_distance[it.handle()])
                     {
-                        VERTEX_TYPE &vertex = data_structure.vertex(it->first);
-                        function(vertex, std::forward<ARGS>(args)...);
+                        paths.update(it.handle(), candidate, handle);
+                        queue.push(it.handle(), candidate);
+
+                        if (candidate + other.m_distance[it.handle()] < best)
+                        {
+                            best = candidate + other.m_distance[it.handle()];
+                            meeting = it.handle();
+                        }
                     }
                 }
             }
-        }
-    };
 
-    template <typename DATA_STRUCTURE>
-    class DFS
-    {
-        using VERTEX_TYPE = typename DATA_STRUCTURE::VERTEX_TYPE;
+            Path path;
+            if (best == std::numeric_limits<float>::infinity())
+            {
+                return path;
+            }
 
-    public:
-        DFS() = default;
-        ~DFS() = default;
+            path.distance = best;
+            path.vertices = m_forward.path(meeting);
+            for (vertex_handle vertex = meeting; vertex != target_handle;)
+            {
+                vertex = m_backward.m_parent[vertex];
+                path.vertices.push_back(vertex);
+            }
+            return path;
+        }
 
-        template <VisitPolicy policy = VisitPolicy::RELATED, typename FUNCTION,
-                  typename... ARGS>
-        void traverse(DATA_STRUCTURE &data_structure, const uuid &id,
-                      FUNCTION &&function, ARGS &&...args)
+        // Delta-stepping on a pool of std::threads. Tentative distances are
+        // kept in buckets of width delta, a delta of 0 uses the mean edge
+        // weight. The light edges, up to delta long, of the vertices in the
+        // current bucket are relaxed in parallel until the bucket stays empty,
+        // then the heavy edges of every vertex it settled are relaxed once.
+        // The buckets are a cyclic array covering the longest edge, capped at
+        // the number of handles, entries of later turns wait in their slot.
+        const ShortestPaths &delta_stepping(const uuid &source, float delta = 0, unsigned threads = std::thread::hardware_concurrency())
         {
-            if (data_structure.size() == 0)
+            SGL_TIME(m_graph.stats(), Phase::SHORTEST_PATH);
+            const vertex_handle source_handle = resolve(source, "[const ShortestPaths &sgl::PathFinder::delta_stepping(const uuid &source, float delta = 0, unsigned threads = std::thread::hardware_concurrency())]");
+            const size_t bound = m_graph.handle_bound();
+
+            if (!(delta >= 0))
             {
-                throw std::out_of_range{"[void sgl::DFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Graph is empty"};
+                throw std::invalid_argument{"[const ShortestPaths &sgl::PathFinder::delta_stepping(const uuid &source, float delta = 0, unsigned threads = std::thread::hardware_concurrency())] delta must not be negative"};
+            }
+
+            // the graph does not change while the PathFinder is in use, the
+            // weights are looked at once
+            if (std::isnan(m_mean_weight))
+            {
+                double weights = 0;
+                size_t edges = 0;
+                m_max_weight = 0;
+                for (auto &vertex : m_graph)
+                {
+                    for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                    {
+                        weights += it.weight();
+                        m_max_weight = std::max(m_max_weight, it.weight());
+                        ++edges;
+                    }
+                }
+                m_mean_weight = edges == 0 ? 0 : static_cast<float>(weights / edges);
+            }
+            if (delta == 0)
+            {
+                delta = m_mean_weight == 0 ? 1 : m_mean_weight;
+            }
+
+            threads = static_cast<unsigned>(std::clamp<size_t>((bound + min_vertices_per_thread - 1) / min_vertices_per_thread, 1, std::max(threads, 1u)));
+
+            // distance and parent packed in one word so that they are updated
+            // together, non-negative floats order the same as their bits
+            auto pack = [](float distance, vertex_handle parent)
+            {
+                return static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(distance)) << 32 | parent;
+            };
+            auto unpack = [](std::uint64_t packed)
+            {
+                return std::bit_cast<float>(static_cast<std::uint32_t>(packed >> 32));
+            };
+            auto bucket = [delta](float distance)
+            {
+                return static_cast<size_t>(distance / delta);
+            };
+
+            // every entry is unreached between queries, only the entries of
+            // the vertices a query touches are reset after it
+            const std::uint64_t unreached = pack(std::numeric_limits<float>::infinity(), ShortestPaths::no_parent);
+            if (m_best_bound != bound)
+            {
+                m_best = std::make_unique<std::atomic<std::uint64_t>[]>(bound);
+                m_best_bound = bound;
+                for (size_t vertex = 0; vertex < bound; ++vertex)
+                {
+                    m_best[vertex].store(unreached, std::memory_order_relaxed);
+                }
             }
 
-            std::stack<uuid> stack;
-            std::set<uuid> visited;
+            // a turn of the cyclic array has to span the longest edge for the
+            // entries of one turn not to collide with the next
+            const double span = static_cast<double>(m_max_weight) / delta + 2;
+            const size_t slots = span < static_cast<double>(std::max<size_t>(bound, 64)) ? static_cast<size_t>(span) : std::max<size_t>(bound, 64);
+            m_buckets.resize(slots);
+            size_t pending = 0;
+
+            m_forward.reset(source_handle, bound);
+            m_best[source_handle].store(pack(0, source_handle), std::memory_order_relaxed);
 
+            size_t current = 0;
+            bool light = true;
+            std::vector<vertex_handle> frontier{source_handle};
+
+            std::vector<std::vector<std::pair<size_t, vertex_handle>>> pushed(threads);
+            // the vertices of the light phases with heavy edges, the heavy
+            // phase does not walk the edges of the others a second time
+            std::vector<std::vector<vertex_handle>> heavy(threads);
+            std::atomic<size_t> cursor{0};
+            bool done = false;
+
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+
+            auto relax = [&](unsigned id)
+            {
+                constexpr size_t chunk = 64;
+                for (size_t first = cursor.fetch_add(chunk, std::memory_order_relaxed); first < frontier.size();
+                     first = cursor.fetch_add(chunk, std::memory_order_relaxed))
+                {
+                    // counted once per chunk, the workers would contend for
+                    // a counter updated per edge
+                    [[maybe_unused]] std::uint64_t relaxed = 0;
+                    for (size_t i = first; i < std::min(first + chunk, frontier.size()); ++i)
+                    {
+                        const vertex_handle handle = frontier[i];
+                        const float distance = unpack(m_best[handle].load(std::memory_order_relaxed));
+                        if (bucket(distance) != current)
+                        {
+                            continue;
+                        }
+
+                        const VERTEX_TYPE &vertex = m_graph.vertex(handle);
+                        bool skipped = false;
+                        for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                        {
+                            if ((it.weight() <= delta) != light)
+                            {
+                                skipped = true;
+                                continue;
+                            }
+                            if constexpr (Stats::enabled)
+                            {
+                                ++relaxed;
+                            }
+                            const float candidate = distance + it.weight();
+                            const std::uint64_t packed = pack(candidate, handle);
+                            std::uint64_t old = m_best[it.handle()].load(std::memory_order_relaxed);
+                            while (candidate < unpack(old))
+                            {
+                                if (m_best[it.handle()].compare_exchange_weak(old, packed, std::memory_order_relaxed))
+                                {
+                                    pushed[id].emplace_back(bucket(candidate), it.handle());
+                                    break;
+                                }
+                            }
+                        }
+                        if (light && skipped)
+                        {
+                            heavy[id].push_back(handle);
+                        }
+                    }
+                    SGL_COUNT(m_graph.stats(), edges_relaxed, relaxed);
+                }
+            };
+
+            // Moves the vertices pushed by the workers into their buckets.
+            // m_best is not written between the phases, so the latest distance
+            // and parent of every pushed vertex are final for this phase.
+            auto collect = [&]()
+            {
+                for (auto &vertices : pushed)
+                {
+                    for (auto &[index, handle] : vertices)
+                    {
+                        const std::uint64_t packed = m_best[handle].load(std::memory_order_relaxed);
+                        m_forward.update(handle, unpack(packed), static_cast<vertex_handle>(packed));
+                        m_buckets[index % slots].emplace_back(index, handle);
+                        ++pending;
+                    }
+                    vertices.clear();
+                }
+            };
+
+            // moves the entries of the current bucket into the frontier, the
+            // ones whose vertex has moved to a closer bucket since are skipped
+            // by relax, which loads the distance anyway
+            auto take = [&]()
+            {
+                frontier.clear();
+                std::erase_if(m_buckets[current % slots], [&](const std::pair<size_t, vertex_handle> &entry)
+                              {
+                    if (entry.first != current)
+                    {
+                        return false;
+                    }
+                    frontier.push_back(entry.second);
+                    --pending;
+                    return true; });
+            };
+
+            // the next bucket with entries, a whole turn without any means
+            // they are more than a turn ahead and current jumps to them
+            auto advance = [&]()
+            {
+                size_t empty_slots = 0;
+                while (pending > 0)
+                {
+                    ++current;
+                    take();
+                    if (!frontier.empty())
+                    {
+                        return true;
+                    }
+                    if (++empty_slots == slots)
+                    {
+                        size_t next = std::numeric_limits<size_t>::max();
+                        for (auto &slot : m_buckets)
+                        {
+                            for (auto &entry : slot)
+                            {
+                                next = std::min(next, entry.first);
+                            }
+                        }
+                        current = next - 1;
+                        empty_slots = 0;
+                    }
+                }
+                return false;
+            };
+
+            // runs on one thread between the phases, a light phase repeats
+            // while the current bucket refills, the heavy phase follows it
+            auto next_frontier = [&]()
+            {
+                collect();
+                if (light)
+                {
+                    take();
+                    if (frontier.empty())
+                    {
+                        for (auto &vertices : heavy)
+                        {
+                            frontier.insert(frontier.end(), vertices.begin(), vertices.end());
+                            vertices.clear();
+                        }
+                        std::sort(frontier.begin(), frontier.end());
+                        frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+                        light = false;
+                    }
+                }
+                else
+                {
+                    frontier.clear();
+                }
+                if (!light && frontier.empty())
+                {
+                    if (advance())
+                    {
+                        light = true;
+                    }
+                    else
+                    {
+                        done = true;
+                    }
+                }
+                cursor.store(0, std::memory_order_relaxed);
+            };
+
+            std::barrier sync{static_cast<std::ptrdiff_t>(threads)};
+
+            auto run = [&](unsigned id)
+            {
+                while (true)
+                {
+                    try
+                    {
+                        relax(id);
+                    }
+                    catch (...)
+                    {
+                        if (!failed.exchange(true))
+                        {
+                            error = std::current_exception();
+                        }
+                    }
+
+                    sync.arrive_and_wait();
+                    if (id == 0)
+                    {
+                        try
+                        {
+                            if (failed.load(std::memory_order_relaxed))
+                            {
+                                done = true;
+                            }
+                            else
+                            {
+                                next_frontier();
+                            }
+                        }
+                        catch (...)
+                        {
+                            failed.store(true);
+                            error = std::current_exception();
+                            done = true;
+                        }
+                    }
+                    sync.arrive_and_wait();
+
+                    if (done)
+                    {
+                        return;
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
             try
             {
-                VERTEX_TYPE &start_vertex = data_structure.vertex(id);
-                stack.push(start_vertex.get_id());
-                visited.insert(start_vertex.get_id());
+                for (unsigned id = 1; id < threads; ++id)
+                {
+                    pool.emplace_back(run, id);
+                }
             }
-            catch (const std::out_of_range &e)
+            catch (const std::system_error &e)
             {
-                throw std::out_of_range{"[void sgl::DFS::traverse(DATA_STRUCTURE &data_structure, const uuid &id, FUNCTION &&function, ARGS &&...args)] Vertex with id " + static_cast<std::string>(id) + " not found"};
+                // the frontier is shared dynamically, the others pick up the work
+                for (size_t id = pool.size() + 1; id < threads; ++id)
+                {
+                    sync.arrive_and_drop();
+                }
+            }
+
+            run(0);
+            for (auto &thread : pool)
+            {
+                thread.join();
+            }
+
+            // leaves m_best and the buckets empty for the next query, after
+            // a failure pushed may still hold vertices m_forward has not seen
+            for (auto &vertex : m_forward.m_touched)
+            {
+                m_best[vertex].store(unreached, std::memory_order_relaxed);
+            }
+            for (auto &vertices : pushed)
+            {
+                for (auto &entry : vertices)
+                {
+                    m_best[entry.second].store(unreached, std::memory_order_relaxed);
+                }
+            }
+            for (auto &slot : m_buckets)
+            {
+                slot.clear();
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            return m_forward;
+        }
+
+        // Runs from(source) for every source of the range and passes each
+        // result to function(const ShortestPaths &paths), the scratch buffers
+        // are shared by all queries.
+        template <typename SOURCES, typename FUNCTION>
+        void from_each(const SOURCES &sources, FUNCTION &&function)
+        {
+            for (const uuid &source : sources)
+            {
+                function(from(source));
+            }
+        }
+
+        // Distances between every source and every target, row-major with one
+        // row per source, infinity where a target is not reachable. Each query
+        // stops once all of the targets are settled.
+        template <typename SOURCES, typename TARGETS>
+        std::vector<float> distance_table(const SOURCES &sources, const TARGETS &targets)
+        {
+            SGL_TIME(m_graph.stats(), Phase::SHORTEST_PATH);
+            const size_t bound = m_graph.handle_bound();
+
+            std::vector<vertex_handle> target_handles;
+            for (const uuid &target : targets)
+            {
+                target_handles.push_back(resolve(target, "[std::vector<float> sgl::PathFinder::distance_table(const SOURCES &sources, const TARGETS &targets)]"));
+            }
+
+            std::vector<bool> is_target(bound, false);
+            size_t distinct_targets = 0;
+            for (auto &target : target_handles)
+            {
+                if (!is_target[target])
+                {
+                    is_target[target] = true;
+                    ++distinct_targets;
+                }
+            }
+
+            std::vector<float> table;
+            for (const uuid &source : sources)
+            {
+                size_t remaining = distinct_targets;
+                search(m_forward, m_heap, resolve(source, "[std::vector<float> sgl::PathFinder::distance_table(const SOURCES &sources, const TARGETS &targets)]"), [&](vertex_handle vertex)
+                       { return is_target[vertex] && --remaining == 0; });
+
+                for (auto &target : target_handles)
+                {
+                    table.push_back(m_forward.distance(target));
+                }
+            }
+            return table;
+        }
+
+    private:
+        // 4-ary min-heap of (distance, handle) pairs with the position of every
+        // handle, so that a shorter distance moves an entry up instead of
+        // pushing a second one
+        class heap
+        {
+            static constexpr size_t arity = 4;
+            static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        public:
+            bool empty() const { return m_items.empty(); }
+            size_t size() const { return m_items.size(); }
+            const std::pair<float, vertex_handle> &top() const { return m_items.front(); }
+
+            void reset(size_t bound)
+            {
+                for (auto &item : m_items)
+                {
+                    m_positions[item.second] = npos;
+                }
+                m_items.clear();
+                m_positions.resize(bound, npos);
+            }
+
+            // inserts the handle or lowers its key, a higher key is ignored
+            void push(vertex_handle handle, float key)
+            {
+                size_t position = m_positions[handle];
+                if (position == npos)
+                {
+                    position = m_items.size();
+                    m_items.emplace_back(key, handle);
+                }
+                else if (key < m_items[position].first)
+                {
+                    m_items[position].first = key;
+                }
+                else
+                {
+                    return;
+                }
+                sift_up(position);
             }
 
-            while (!stack.empty())
+            std::pair<float, vertex_handle> pop()
             {
-                VERTEX_TYPE &vertex = data_structure.vertex(stack.top());
-                stack.pop();
+                std::pair<float, vertex_handle> top = m_items.front();
+                m_positions[top.second] = npos;
 
-                function(vertex, std::forward<ARGS>(args)...);
+                std::pair<float, vertex_handle> last = m_items.back();
+                m_items.pop_back();
+                if (!m_items.empty())
+                {
+                    m_items.front() = last;
+                    m_positions[last.second] = 0;
+                    sift_down(0);
+                }
+                return top;
+            }
 
-                for (auto it = data_structure.begin(vertex.get_id());
-                     it != data_structure.end(vertex.get_id()); ++it)
+        private:
+            void sift_up(size_t position)
+            {
+                std::pair<float, vertex_handle> item = m_items[position];
+                while (position > 0)
                 {
-                    if (visited.find(it->get_id()) == visited.end())
+                    size_t parent = (position - 1) / arity;
+                    if (m_items[parent].first <= item.first)
                     {
-                        stack.push(it->get_id());
-                        visited.insert(it->get_id());
+                        break;
                     }
+                    m_items[position] = m_items[parent];
+                    m_positions[m_items[position].second] = position;
+                    position = parent;
                 }
+                m_items[position] = item;
+                m_positions[item.second] = position;
             }
 
-            if constexpr (policy)
+            void sift_down(size_t position)
             {
-                for (auto it = data_structure.m_vertices.begin();
-                     it != data_structure.m_vertices.end(); ++it)
+                std::pair<float, vertex_handle> item = m_items[position];
+                while (true)
                 {
-                    if (visited.find(it->first) == visited.end())
+                    size_t first = position * arity + 1;
+                    if (first >= m_items.size())
                     {
-                        VERTEX_TYPE &vertex = data_structure.vertex(it->first);
-                        function(vertex, std::forward<ARGS>(args)...);
+                        break;
+                    }
+
+                    size_t smallest = first;
+                    for (size_t child = first + 1; child < std::min(first + arity, m_items.size()); ++child)
+                    {
+                        if (m_items[child].first < m_items[smallest].first)
+                        {
+                            smallest = child;
+                        }
                     }
+
+                    if (item.first <= m_items[smallest].first)
+                    {
+                        break;
+                    }
+                    m_items[position] = m_items[smallest];
+                    m_positions[m_items[position].second] = position;
+                    position = smallest;
                 }
+                m_items[position] = item;
+                m_positions[item.second] = position;
             }
-        }
-    };
 
-    template <typename GRAPH>
-    std::map<uuid, std::pair<float, std::vector<uuid>>> dijkstra(const GRAPH &graph, const uuid &id)
-    {
-        std::map<uuid, std::pair<float, std::vector<uuid>>> output;
-        std::priority_queue<std::pair<float, uuid>, std::vector<std::pair<float, uuid>>, std::greater<std::pair<float, uuid>>> queue;
-        const auto &start_vertex = graph.vertex(id);
+            std::vector<std::pair<float, vertex_handle>> m_items;
+            std::vector<size_t> m_positions;
+        };
 
-        for (auto &vertex : graph)
+        vertex_handle resolve(const uuid &id, const std::string &signature) const
         {
-            if (vertex.get_id() == start_vertex.get_id())
+            try
             {
-                output[vertex.get_id()] = std::make_pair(0, std::vector<uuid>{});
+                return m_graph.handle(id);
             }
-            else
+            catch (const std::out_of_range &e)
             {
-                output[vertex.get_id()] = std::make_pair(std::numeric_limits<float>::infinity(), std::vector<uuid>{});
+                throw std::out_of_range{signature + " Vertex with id " + static_cast<std::string>(id) + " not found"};
             }
         }
 
-        queue.push(std::make_pair(0, start_vertex.get_id()));
-
-        while (!queue.empty())
+        // Dijkstra's algorithm, stop(handle) is asked for every settled vertex
+        // and ends the search when it returns true
+        template <typename STOP>
+        void search(ShortestPaths &paths, heap &queue, vertex_handle source, STOP &&stop)
         {
-            auto [distance, vertex_id] = queue.top();
-            queue.pop();
+            const size_t bound = m_graph.handle_bound();
+            paths.reset(source, bound);
+            queue.reset(bound);
+            queue.push(source, 0);
 
-            for (auto &neighbor : graph(vertex_id))
+            while (!queue.empty())
             {
-                float weight = graph.get_weight(vertex_id, neighbor.get_id());
+                auto [distance, handle] = queue.pop();
+                if (stop(handle))
+                {
+                    return;
+                }
 
-                if (output[neighbor.get_id()].first > distance + weight)
+                const VERTEX_TYPE &vertex = m_graph.vertex(handle);
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
                 {
-                    output[neighbor.get_id()].first = distance + weight;
-                    output[neighbor.get_id()].second = output[vertex_id].second;
-                    output[neighbor.get_id()].second.push_back(vertex_id);
-                    queue.push(std::make_pair(output[neighbor.get_id()].first, neighbor.get_id()));
+                    SGL_COUNT(m_graph.stats(), edges_relaxed, 1);
+                    const float candidate = distance + it.weight();
+                    if (candidate < paths.m_distance[it.handle()])
+                    {
+                        paths.update(it.handle(), candidate, handle);
+                        queue.push(it.handle(), candidate);
+                    }
                 }
             }
         }
 
-        // insert starting to the back of vector the uuid of the specified vertex
-        for (auto &[vertex_id, pair] : output)
-        {
-            pair.second.push_back(vertex_id);
-        }
+        const GRAPH &m_graph;
+
+        ShortestPaths m_forward;
+        ShortestPaths m_backward;
+        heap m_heap;
+        heap m_backward_heap;
+        std::vector<float> m_estimates;
+        std::vector<vertex_handle> m_estimated;
+        // delta-stepping scratch, NaN mean weight until the weights are read
+        float m_mean_weight = std::numeric_limits<float>::quiet_NaN();
+        float m_max_weight = 0;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> m_best;
+        size_t m_best_bound = 0;
+        std::vector<std::vector<std::pair<size_t, vertex_handle>>> m_buckets;
+    };
 
-        return output;
+    template <typename GRAPH>
+    ShortestPaths dijkstra(const GRAPH &graph, const uuid &id)
+    {
+        return PathFinder<GRAPH>{graph}.from(id);
     }
 
     template <typename GRAPH>
-    void print_dijkstra(const GRAPH &graph, const std::map<uuid, std::pair<float, std::vector<uuid>>> &map)
+    void print_dijkstra(const GRAPH &graph, const ShortestPaths &paths)
     {
-        for (auto &v : map)
+        for (auto &v : graph)
         {
-            std::cout << graph(v.first) << "\t" << v.second.first << "\t\t";
-            for (auto &u : v.second.second)
-                std::cout << graph(u) << " ";
+            std::cout << v << "\t" << paths.distance(v.get_handle()) << "\t\t";
+            for (auto &u : paths.path(v.get_handle()))
+                std::cout << graph.vertex(u) << " ";
             std::cout << std::endl;
         }
     }
@@ -1687,6 +4261,607 @@ namespace sgl
     //
     //////////////////////////////////////////////////////////////////////////////
 
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    //       BINARY I/O
+    //
+
+    namespace io
+    {
+        // Serializer hook for vertex data that is not trivially copyable,
+        // which is stored as a byte string per vertex. Specializations provide
+        //
+        //     static size_t size(const DATA_TYPE &data);
+        //     static void write(std::ostream &os, const DATA_TYPE &data);
+        //     static DATA_TYPE read(std::string_view bytes);
+        //
+        // where write outputs exactly size(data) bytes. Trivially copyable data
+        // is stored raw and does not use the hook.
+        template <typename DATA_TYPE>
+        struct serializer;
+
+        template <>
+        struct serializer<std::string>
+        {
+            static size_t size(const std::string &data) { return data.size(); }
+            static void write(std::ostream &os, const std::string &data) { os.write(data.data(), static_cast<std::streamsize>(data.size())); }
+            static std::string read(std::string_view bytes) { return std::string{bytes}; }
+        };
+
+        template <typename DATA_TYPE>
+        concept raw_data = std::is_trivially_copyable_v<DATA_TYPE>;
+
+        template <typename DATA_TYPE>
+        concept serializable_data = raw_data<DATA_TYPE> || requires(std::ostream &os, const DATA_TYPE &data, std::string_view bytes) {
+            { serializer<DATA_TYPE>::size(data) } -> std::convertible_to<size_t>;
+            serializer<DATA_TYPE>::write(os, data);
+            { serializer<DATA_TYPE>::read(bytes) } -> std::convertible_to<DATA_TYPE>;
+        };
+
+        // File layout, every section starts at a multiple of alignment bytes
+        // from the start of the file:
+        //
+        //     header
+        //     ids           uuid[vertices]
+        //     index         vertex_handle[vertices], the handles sorted by id
+        //     offsets       uint64_t[vertices + 1], CSR row offsets
+        //     targets       vertex_handle[entries], neighbors sorted by handle
+        //     weights       float[entries]
+        //     data_offsets  uint64_t[vertices + 1], only for serialized data
+        //     data          DATA_TYPE[vertices] or the serialized bytes
+        //
+        // Every edge is stored in the rows of both of its vertices, so entries
+        // is twice the number of edges. Vertex handles are the positions in the
+        // file, the handles of the saved graph are not kept. Numbers are stored
+        // in the byte order of the machine that saved the file, which is
+        // recorded in the header and checked when the file is opened.
+        struct header
+        {
+            static constexpr char signature[8] = {'S', 'G', 'L', 'G', 'R', 'A', 'P', 'H'};
+            static constexpr std::uint32_t current_version = 1;
+            static constexpr std::uint32_t byte_order = 0x01020304;
+            static constexpr std::uint64_t alignment = 64;
+
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t endianness;
+            std::uint64_t vertices;
+            std::uint64_t entries;
+            // sizeof and alignof DATA_TYPE for raw data, 0 for serialized data
+            std::uint32_t data_size;
+            std::uint32_t data_alignment;
+            std::uint64_t data_bytes;
+
+            // file offsets of the sections
+            std::uint64_t ids;
+            std::uint64_t index;
+            std::uint64_t offsets;
+            std::uint64_t targets;
+            std::uint64_t weights;
+            std::uint64_t data_offsets;
+            std::uint64_t data;
+            std::uint64_t file_size;
+
+            static std::uint64_t align(std::uint64_t offset) { return (offset + alignment - 1) / alignment * alignment; }
+
+            // fills in everything from the sizes of the graph
+            template <typename DATA_TYPE>
+            static header layout(std::uint64_t vertices, std::uint64_t entries, std::uint64_t data_bytes)
+            {
+                header h{};
+                std::copy_n(signature, sizeof(signature), h.magic);
+                h.version = current_version;
+                h.endianness = byte_order;
+                h.vertices = vertices;
+                h.entries = entries;
+                if constexpr (raw_data<DATA_TYPE>)
+                {
+                    static_assert(alignof(DATA_TYPE) <= alignment, "raw data is only aligned to header::alignment in the file");
+                    h.data_size = sizeof(DATA_TYPE);
+                    h.data_alignment = alignof(DATA_TYPE);
+                    data_bytes = vertices * sizeof(DATA_TYPE);
+                }
+                h.data_bytes = data_bytes;
+
+                h.ids = align(sizeof(header));
+                h.index = align(h.ids + vertices * sizeof(uuid));
+                h.offsets = align(h.index + vertices * sizeof(vertex_handle));
+                h.targets = align(h.offsets + (vertices + 1) * sizeof(std::uint64_t));
+                h.weights = align(h.targets + entries * sizeof(vertex_handle));
+                h.data_offsets = align(h.weights + entries * sizeof(float));
+                h.data = raw_data<DATA_TYPE> ? h.data_offsets : align(h.data_offsets + (vertices + 1) * sizeof(std::uint64_t));
+                h.file_size = align(h.data + data_bytes);
+                return h;
+            }
+        };
+
+        static_assert(std::is_trivially_copyable_v<header> && std::is_trivially_copyable_v<uuid> && sizeof(uuid) == 16);
+
+        // Writes a graph section by section straight from its data structure,
+        // so saving needs no copy of the graph, only a few arrays with one
+        // element per vertex. The stream does not have to be seekable.
+        template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
+            requires serializable_data<DATA_TYPE>
+        void save(const Graph<DATA_TYPE, DATA_STRUCTURE> &graph, std::ostream &os)
+        {
+            // vertices are stored in iteration order, dense[handle] is the
+            // position of a vertex in the file
+            std::vector<vertex_handle> dense(graph.handle_bound());
+            std::vector<vertex_handle> handles;
+            handles.reserve(graph.size());
+            std::uint64_t entries = 0;
+            std::uint64_t data_bytes = 0;
+            for (auto &vertex : graph)
+            {
+                dense[vertex.get_handle()] = static_cast<vertex_handle>(handles.size());
+                handles.push_back(vertex.get_handle());
+                entries += vertex.size();
+                if constexpr (!raw_data<DATA_TYPE>)
+                {
+                    data_bytes += serializer<DATA_TYPE>::size(vertex.data());
+                }
+            }
+
+            const header h = header::template layout<DATA_TYPE>(handles.size(), entries, data_bytes);
+
+            std::uint64_t position = 0;
+            auto write = [&os, &position](const void *data, size_t size)
+            {
+                os.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+                position += size;
+            };
+            auto pad = [&os, &position](std::uint64_t offset)
+            {
+                for (; position < offset; ++position)
+                {
+                    os.put('\0');
+                }
+            };
+
+            write(&h, sizeof(header));
+
+            pad(h.ids);
+            for (auto &vertex : graph)
+            {
+                write(&vertex.get_id(), sizeof(uuid));
+            }
+
+            pad(h.index);
+            std::vector<vertex_handle> index(handles.size());
+            std::iota(index.begin(), index.end(), vertex_handle{0});
+            std::sort(index.begin(), index.end(), [&graph, &handles](vertex_handle vertex1, vertex_handle vertex2)
+                      { return graph.vertex(handles[vertex1]).get_id() < graph.vertex(handles[vertex2]).get_id(); });
+            write(index.data(), index.size() * sizeof(vertex_handle));
+
+            pad(h.offsets);
+            std::uint64_t offset = 0;
+            write(&offset, sizeof(offset));
+            for (auto &vertex : graph)
+            {
+                offset += vertex.size();
+                write(&offset, sizeof(offset));
+            }
+
+            // the rows are sorted once for the targets and once for the weights
+            std::vector<std::pair<vertex_handle, float>> row;
+            auto sorted_row = [&row, &dense](const auto &vertex)
+            {
+                row.clear();
+                for (auto it = vertex.begin(); it != vertex.end(); ++it)
+                {
+                    row.emplace_back(dense[it.handle()], it.weight());
+                }
+                std::sort(row.begin(), row.end());
+            };
+
+            pad(h.targets);
+            for (auto &vertex : graph)
+            {
+                sorted_row(vertex);
+                for (auto &[target, weight] : row)
+                {
+                    write(&target, sizeof(target));
+                }
+            }
+
+            pad(h.weights);
+            for (auto &vertex : graph)
+            {
+                sorted_row(vertex);
+                for (auto &[target, weight] : row)
+                {
+                    write(&weight, sizeof(weight));
+                }
+            }
+
+            if constexpr (raw_data<DATA_TYPE>)
+            {
+                pad(h.data);
+                for (auto &vertex : graph)
+                {
+                    write(&vertex.data(), sizeof(DATA_TYPE));
+                }
+            }
+            else
+            {
+                pad(h.data_offsets);
+                offset = 0;
+                write(&offset, sizeof(offset));
+                for (auto &vertex : graph)
+                {
+                    offset += serializer<DATA_TYPE>::size(vertex.data());
+                    write(&offset, sizeof(offset));
+                }
+
+                pad(h.data);
+                for (auto &vertex : graph)
+                {
+                    serializer<DATA_TYPE>::write(os, vertex.data());
+                }
+                position += data_bytes;
+            }
+            pad(h.file_size);
+
+            if (!os)
+            {
+                throw std::runtime_error("[void sgl::io::save(const Graph<DATA_TYPE, DATA_STRUCTURE> &graph, std::ostream &os)] Writing the graph failed");
+            }
+        }
+
+        template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE>
+            requires serializable_data<DATA_TYPE>
+        void save(const Graph<DATA_TYPE, DATA_STRUCTURE> &graph, const std::string &path)
+        {
+            std::ofstream os{path, std::ios::binary | std::ios::trunc};
+            if (!os)
+            {
+                throw std::runtime_error("[void sgl::io::save(const Graph<DATA_TYPE, DATA_STRUCTURE> &graph, const std::string &path)] Cannot open " + path);
+            }
+            save(graph, os);
+        }
+
+        // Read-only view of a saved graph. On systems with mmap the file is
+        // mapped privately, so pages are loaded when they are first accessed
+        // and writes to them never reach the file. Elsewhere the file is read
+        // into memory aligned like the sections.
+        //
+        // The header, the section bounds, the row offsets and the targets are
+        // checked when the file is opened, which reads the offset and target
+        // sections once. Vertex data and weights are trusted.
+        template <typename DATA_TYPE>
+        class MappedGraph
+        {
+            static_assert(serializable_data<DATA_TYPE>, "sgl::io::serializer has to be specialized for data types that are not trivially copyable");
+
+            friend class CSRGraph<DATA_TYPE>;
+
+        public:
+            explicit MappedGraph(const std::string &path)
+            {
+#if SGL_HAS_MMAP
+                int file = ::open(path.c_str(), O_RDONLY);
+                if (file < 0)
+                {
+                    throw std::system_error{errno, std::generic_category(), "[sgl::io::MappedGraph::MappedGraph(const std::string &path)] Cannot open " + path};
+                }
+                struct stat status;
+                if (::fstat(file, &status) != 0)
+                {
+                    int error = errno;
+                    ::close(file);
+                    throw std::system_error{error, std::generic_category(), "[sgl::io::MappedGraph::MappedGraph(const std::string &path)] Cannot stat " + path};
+                }
+                m_size = static_cast<size_t>(status.st_size);
+                // writable for the weights of csr(), the pages written to are
+                // copied and never written back
+                void *mapping = m_size == 0 ? MAP_FAILED : ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+                int error = errno;
+                ::close(file);
+                if (mapping == MAP_FAILED)
+                {
+                    throw std::system_error{m_size == 0 ? EINVAL : error, std::generic_category(), "[sgl::io::MappedGraph::MappedGraph(const std::string &path)] Cannot map " + path};
+                }
+                m_file = static_cast<const std::byte *>(mapping);
+#else
+                // the streams do not report why they failed, errno usually does
+                std::ifstream is{path, std::ios::binary | std::ios::ate};
+                if (!is)
+                {
+                    throw std::system_error{errno, std::generic_category(), "[sgl::io::MappedGraph::MappedGraph(const std::string &path)] Cannot open " + path};
+                }
+                m_size = static_cast<size_t>(is.tellg());
+                // the sections are aligned to header::alignment from the start
+                // of the file, so must be the buffer
+                m_buffer.reset(static_cast<std::byte *>(::operator new[](m_size, std::align_val_t{header::alignment})));
+                is.seekg(0);
+                is.read(reinterpret_cast<char *>(m_buffer.get()), static_cast<std::streamsize>(m_size));
+                if (!is)
+                {
+                    throw std::system_error{errno, std::generic_category(), "[sgl::io::MappedGraph::MappedGraph(const std::string &path)] Cannot read " + path};
+                }
+                m_file = m_buffer.get();
+#endif
+                try
+                {
+                    check();
+                }
+                catch (...)
+                {
+                    unmap();
+                    throw;
+                }
+            }
+
+            MappedGraph(const MappedGraph &other) = delete;
+            MappedGraph &operator=(const MappedGraph &other) = delete;
+            MappedGraph(MappedGraph &&other) noexcept
+                : m_file{std::exchange(other.m_file, nullptr)}, m_size{std::exchange(other.m_size, 0)}, m_header{other.m_header}, m_buffer{std::move(other.m_buffer)} {}
+            MappedGraph &operator=(MappedGraph &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    unmap();
+                    m_file = std::exchange(other.m_file, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                    m_header = other.m_header;
+                    m_buffer = std::move(other.m_buffer);
+                }
+                return *this;
+            }
+            ~MappedGraph() { unmap(); }
+
+            size_t size() const { return m_header->vertices; }
+            size_t size(vertex_handle vertex) const
+            {
+                if (!contains(vertex))
+                {
+                    throw std::out_of_range{"[size_t sgl::io::MappedGraph::size(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+                }
+                return offsets()[vertex + 1] - offsets()[vertex];
+            }
+
+            bool contains(vertex_handle vertex) const { return vertex < size(); }
+
+            // binary search in the index section
+            vertex_handle handle(const uuid &id) const
+            {
+                auto index = section<vertex_handle>(m_header->index, size());
+                auto it = std::lower_bound(index.begin(), index.end(), id, [this](vertex_handle vertex, const uuid &id)
+                                           { return ids()[vertex] < id; });
+                if (it == index.end() || ids()[*it] != id)
+                {
+                    throw std::out_of_range{"[vertex_handle sgl::io::MappedGraph::handle(const uuid &id) const] Vertex with id " + static_cast<std::string>(id) + " not found"};
+                }
+                return *it;
+            }
+
+            const uuid &id(vertex_handle vertex) const
+            {
+                if (!contains(vertex))
+                {
+                    throw std::out_of_range{"[const uuid &sgl::io::MappedGraph::id(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+                }
+                return ids()[vertex];
+            }
+
+            // a reference into the file for raw data, a deserialized copy
+            // otherwise
+            decltype(auto) data(vertex_handle vertex) const
+            {
+                if (!contains(vertex))
+                {
+                    throw std::out_of_range{"[decltype(auto) sgl::io::MappedGraph::data(vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+                }
+
+                if constexpr (raw_data<DATA_TYPE>)
+                {
+                    return static_cast<const DATA_TYPE &>(section<DATA_TYPE>(m_header->data, size())[vertex]);
+                }
+                else
+                {
+                    auto data_offsets = section<std::uint64_t>(m_header->data_offsets, size() + 1);
+                    const char *bytes = reinterpret_cast<const char *>(m_file + m_header->data);
+                    return static_cast<DATA_TYPE>(serializer<DATA_TYPE>::read(std::string_view{bytes + data_offsets[vertex], data_offsets[vertex + 1] - data_offsets[vertex]}));
+                }
+            }
+            decltype(auto) data(const uuid &id) const { return data(handle(id)); }
+
+            // neighbors of a vertex sorted by handle, with the weights of the
+            // edges at the same positions of weights(vertex)
+            std::span<const vertex_handle> neighbors(vertex_handle vertex) const { return row<vertex_handle>(m_header->targets, vertex); }
+            std::span<const float> weights(vertex_handle vertex) const { return row<float>(m_header->weights, vertex); }
+
+            const float &weight(vertex_handle vertex1, vertex_handle vertex2) const
+            {
+                if (vertex1 == vertex2)
+                {
+                    throw std::invalid_argument("[const float &sgl::io::MappedGraph::weight(vertex_handle vertex1, vertex_handle vertex2) const] vertex1 and vertex2 must be different");
+                }
+
+                if (!contains(vertex1) || !contains(vertex2))
+                {
+                    throw std::out_of_range{"[const float &sgl::io::MappedGraph::weight(vertex_handle vertex1, vertex_handle vertex2) const] Vertex with handle " + std::to_string(vertex1) + " or " + std::to_string(vertex2) + " not found"};
+                }
+
+                auto targets = neighbors(vertex1);
+                auto it = std::lower_bound(targets.begin(), targets.end(), vertex2);
+                if (it == targets.end() || *it != vertex2)
+                {
+                    throw std::out_of_range{"[const float &sgl::io::MappedGraph::weight(vertex_handle vertex1, vertex_handle vertex2) const] Edge between vertex with id " + static_cast<std::string>(ids()[vertex1]) + " and vertex with id " + static_cast<std::string>(ids()[vertex2]) + " not found"};
+                }
+                return weights(vertex1)[it - targets.begin()];
+            }
+            const float &weight(const uuid &vertex1, const uuid &vertex2) const { return weight(handle(vertex1), handle(vertex2)); }
+
+            // mutable copy of the graph with the same ids, the handles of the
+            // copy are the handles of the file
+            template <template <typename> typename DATA_STRUCTURE = AdjacencyList>
+            Graph<DATA_TYPE, DATA_STRUCTURE> thaw(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const
+            {
+                using VERTEX_TYPE = Vertex<DATA_TYPE, DATA_STRUCTURE>;
+
+                Graph<DATA_TYPE, DATA_STRUCTURE> graph{resource};
+                graph.reserve(size(), m_header->entries / 2);
+                for (vertex_handle vertex = 0; vertex < size(); ++vertex)
+                {
+                    VERTEX_TYPE copy{DATA_TYPE(data(vertex))};
+                    copy.m_uuid = ids()[vertex];
+                    graph.add_vertex(std::move(copy));
+                }
+
+                // edges are added in batches to bound the extra memory
+                constexpr size_t batch_size = size_t{1} << 20;
+                std::vector<Edge> batch;
+                batch.reserve(std::min<size_t>(batch_size, m_header->entries / 2));
+                for (vertex_handle vertex = 0; vertex < size(); ++vertex)
+                {
+                    auto targets = neighbors(vertex);
+                    auto edge_weights = weights(vertex);
+                    for (size_t i = 0; i < targets.size(); ++i)
+                    {
+                        if (vertex < targets[i])
+                        {
+                            batch.push_back({vertex, targets[i], edge_weights[i]});
+                        }
+                    }
+                    if (batch.size() >= batch_size)
+                    {
+                        graph.add_edges(batch);
+                        batch.clear();
+                    }
+                }
+                graph.add_edges(batch);
+                return graph;
+            }
+
+            // Immutable graph over the file for BFS, DFS, ParallelBFS and
+            // PathFinder. Only the vertices are copied, the rows are used in
+            // place, so the MappedGraph has to outlive it. The handles are the
+            // positions in the file. Weights written through it change the
+            // mapping, which every graph returned by csr() shares.
+            Graph<DATA_TYPE, CSRGraph> csr(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const
+            {
+                Graph<DATA_TYPE, CSRGraph> graph{resource};
+                graph.assign(*this);
+                return graph;
+            }
+
+        private:
+            struct aligned_delete
+            {
+                void operator()(std::byte *buffer) const { ::operator delete[](buffer, std::align_val_t{header::alignment}); }
+            };
+
+            const std::byte *m_file = nullptr;
+            size_t m_size = 0;
+            const header *m_header = nullptr;
+            // holds the file where it cannot be mapped
+            std::unique_ptr<std::byte[], aligned_delete> m_buffer;
+
+            void check()
+            {
+                if (m_size < sizeof(header))
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] File is too small for a graph");
+                }
+                m_header = reinterpret_cast<const header *>(m_file);
+
+                if (!std::equal(std::begin(header::signature), std::end(header::signature), m_header->magic))
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] File is not a graph");
+                }
+                if (m_header->endianness != header::byte_order)
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] Graph was saved with a different byte order");
+                }
+                if (m_header->version != header::current_version)
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] Unsupported version " + std::to_string(m_header->version));
+                }
+
+                const bool raw = raw_data<DATA_TYPE>;
+                if (raw != (m_header->data_size != 0) || (raw && (m_header->data_size != sizeof(DATA_TYPE) || m_header->data_alignment != alignof(DATA_TYPE))))
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] Graph was saved with a different data type");
+                }
+
+                // the layout is a function of the sizes, a file whose offsets
+                // differ from it is damaged, sizes larger than the file could
+                // overflow the computed offsets
+                if (m_header->vertices > m_size || m_header->entries > m_size || m_header->data_bytes > m_size)
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] File is truncated or damaged");
+                }
+                const header expected = header::template layout<DATA_TYPE>(m_header->vertices, m_header->entries, m_header->data_bytes);
+                if (std::memcmp(&expected, m_header, sizeof(header)) != 0 || m_header->file_size > m_size)
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] File is truncated or damaged");
+                }
+
+                // every row and every vertex data has to lie within its section
+                // and every neighbor has to be a vertex, for the accessors and
+                // csr() not to read past them
+                auto ascending = [](std::span<const std::uint64_t> offsets, std::uint64_t end)
+                {
+                    return offsets.front() == 0 && offsets.back() == end && std::is_sorted(offsets.begin(), offsets.end());
+                };
+                if (!ascending(offsets(), m_header->entries) || (!raw && !ascending(section<std::uint64_t>(m_header->data_offsets, size() + 1), m_header->data_bytes)))
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] File is truncated or damaged");
+                }
+                auto targets = section<vertex_handle>(m_header->targets, m_header->entries);
+                if (std::any_of(targets.begin(), targets.end(), [this](vertex_handle target)
+                                { return target >= size(); }))
+                {
+                    throw std::runtime_error("[void sgl::io::MappedGraph::check()] File is truncated or damaged");
+                }
+            }
+
+            void unmap()
+            {
+#if SGL_HAS_MMAP
+                if (m_file != nullptr)
+                {
+                    ::munmap(const_cast<std::byte *>(m_file), m_size);
+                }
+#endif
+                m_file = nullptr;
+            }
+
+            template <typename TYPE>
+            std::span<const TYPE> section(std::uint64_t offset, size_t count) const
+            {
+                return std::span<const TYPE>{reinterpret_cast<const TYPE *>(m_file + offset), count};
+            }
+
+            std::span<const uuid> ids() const { return section<uuid>(m_header->ids, size()); }
+            std::span<const std::uint64_t> offsets() const { return section<std::uint64_t>(m_header->offsets, size() + 1); }
+            // the mapping is writable, see csr()
+            std::span<float> weight_section() const { return std::span<float>{reinterpret_cast<float *>(const_cast<std::byte *>(m_file) + m_header->weights), m_header->entries}; }
+
+            template <typename TYPE>
+            std::span<const TYPE> row(std::uint64_t offset, vertex_handle vertex) const
+            {
+                if (!contains(vertex))
+                {
+                    throw std::out_of_range{"[std::span<const TYPE> sgl::io::MappedGraph::row(std::uint64_t offset, vertex_handle vertex) const] Vertex with handle " + std::to_string(vertex) + " not found"};
+                }
+                return section<TYPE>(offset, m_header->entries).subspan(offsets()[vertex], offsets()[vertex + 1] - offsets()[vertex]);
+            }
+        };
+
+        template <typename DATA_TYPE, template <typename> typename DATA_STRUCTURE = AdjacencyList>
+        Graph<DATA_TYPE, DATA_STRUCTURE> load(const std::string &path, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        {
+            return MappedGraph<DATA_TYPE>{path}.template thaw<DATA_STRUCTURE>(resource);
+        }
+    }
+
+    //
+    //       END OF BINARY I/O
+    //
+    //////////////////////////////////////////////////////////////////////////////
+
 } // namespace sgl
 
 #endif // SGL_HH